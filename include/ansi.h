@@ -0,0 +1,72 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANSI_H
+#define ANSI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "backend.h"
+#include "game.h"
+
+typedef struct {
+	uint32_t ch;
+	int color;
+} ScreenCell;
+
+// A terminal that is drawn on with escape sequences: a copy of what should be
+// on it, a copy of what it shows, and the frame that turns one into the
+// other.
+typedef struct {
+	int width;
+	int height;
+	ScreenCell* cells;
+	ScreenCell* shown;
+	char* frame;
+	size_t frame_size;
+	size_t frame_capacity;
+	// the color the terminal is drawing with, or -1 if unknown
+	int color;
+	bool clear_pending;
+	bool unicode_boxes;
+	char color_codes[N_PIECES + 2][24];
+} AnsiScreen;
+
+// the screen that the ansi backend's drawing calls draw on
+extern AnsiScreen* ansi_screen;
+
+void ansi_screen_init(AnsiScreen* screen, bool truecolor, bool colors_256, bool unicode_boxes);
+void ansi_screen_set_colors(AnsiScreen* screen, bool truecolor, bool colors_256);
+void ansi_screen_clear(AnsiScreen* screen);
+void ansi_screen_free(AnsiScreen* screen);
+void ansi_screen_resize(AnsiScreen* screen, int width, int height);
+void ansi_screen_compose(AnsiScreen* screen);
+
+void ansi_init_window(Window* window);
+void ansi_resize_window(Window* window);
+void ansi_update(Window window);
+void ansi_print(int y, int x, const char* format, ...);
+void ansi_erase_window(Window window);
+void ansi_erase_line(int x, int y);
+void ansi_clear_screen(void);
+void ansi_draw_cell(Window window, int x, int y, int color);
+void ansi_draw_box(Window window);
+
+#endif
@@ -20,6 +20,8 @@
 #ifndef BACKEND_H
 #define BACKEND_H
 
+#include <stdbool.h>
+
 #define K_LEFT  (-1)
 #define K_RIGHT (-2)
 #define K_UP    (-3)
@@ -44,7 +46,7 @@ typedef enum {
 typedef struct Backend {
        void (*init)(void);
        void (*exit)(void);
-       KeyType (*get_key)(int, int*);
+       KeyType (*get_key)(double, int*, double*);
        void (*init_window)(Window*);
        void (*resize_window)(Window*);
        void (*full_update)(void);
@@ -57,6 +59,11 @@ typedef struct Backend {
        void (*draw_box)(Window);
        void (*get_size)(int*, int*);
        void (*set_target_size)(int, int);
+       // if set, get_key is called from its own thread, and every other
+       // call is made between lock and unlock
+       bool threaded_input;
+       void (*lock)(void);
+       void (*unlock)(void);
 } Backend;
 
 #endif
@@ -0,0 +1,78 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "citrus.h"
+
+#define BITBOARD_MAX_WIDTH 64
+#define BITBOARD_MAX_HEIGHT 64
+// enough for drop_placements, which finds at most one placement per column
+// and rotation
+#define MAX_PLACEMENTS (BITBOARD_MAX_WIDTH * 4)
+
+// A board with one bit per cell, bit x of rows[y] being the cell in column
+// x of row y. Row 0 is the bottom, like in libcitrus.
+typedef struct {
+	int width;
+	int height;
+	uint64_t rows[BITBOARD_MAX_HEIGHT];
+} Bitboard;
+
+// Where a piece ends up. x and y are the bottom left corner of the piece's
+// bounding box, and rotation is the SRS rotation state (0 is spawn, 1 is
+// clockwise).
+typedef struct {
+	int piece;
+	int x;
+	int y;
+	int rotation;
+	bool spin;
+} Placement;
+
+typedef struct {
+	int width;
+	int height;
+	int spawn_row;
+	int n_states;
+	uint32_t* visited;
+	uint32_t stamp;
+	int* queue;
+	// most placements generate_placements can find
+	int max_placements;
+	uint64_t* seen;
+	uint32_t* seen_stamps;
+	unsigned int seen_mask;
+} Generator;
+
+void init_piece_shapes(void);
+bool bitboard_from_cells(Bitboard* bitboard, const CitrusCell* cells, int width, int height);
+void bitboard_to_cells(const Bitboard* bitboard, CitrusCell* cells, CitrusCell full, CitrusCell empty);
+void generator_init(Generator* generator, int width, int height, int spawn_row);
+void generator_free(Generator* generator);
+int generate_placements(Generator* generator, const Bitboard* bitboard, int piece, Placement* placements);
+int drop_placements(const Bitboard* bitboard, int piece, int spawn_row, Placement* placements);
+int placement_shift(const Placement* placement, int width);
+int place_piece(Bitboard* bitboard, const Placement* placement);
+uint64_t perft(Generator* generator, const Bitboard* bitboard, const int* queue, int depth);
+
+#endif
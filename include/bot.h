@@ -0,0 +1,63 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOT_H
+#define BOT_H
+
+#include <stdbool.h>
+#include "bitboard.h"
+
+// the most pieces a search looks ahead, counting the current one
+#define MAX_SEARCH_PIECES 8
+
+// a board in the beam, and which first move led to it
+typedef struct {
+	Bitboard board;
+	double score;
+	int first;
+} BeamNode;
+
+typedef struct {
+	int parent;
+	int placement;
+	double score;
+} BeamCandidate;
+
+typedef struct {
+	int max_width;
+	BeamNode* beam;
+	BeamNode* next_beam;
+	BeamCandidate* candidates;
+	Placement* placements;
+} BotSearch;
+
+typedef struct {
+	long nodes;
+	int width;
+	int depth;
+} BotSearchStats;
+
+double evaluate_board(const Bitboard* bitboard, int landing_height, int lines);
+bool bot_best_drop(const Bitboard* bitboard, int piece, int spawn_row, Placement* best);
+void bot_search_init(BotSearch* search, int max_width);
+void bot_search_free(BotSearch* search);
+bool bot_search(BotSearch* search, const Bitboard* bitboard, const int* pieces, int n_pieces, int spawn_row,
+	double deadline, Placement* best, BotSearchStats* stats);
+
+#endif
@@ -0,0 +1,35 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLIENT_H
+#define CLIENT_H
+
+#include <stdbool.h>
+#include "game.h"
+
+bool client_connect(const char* address, int room);
+bool client_watch(const char* address);
+void client_disconnect(void);
+bool client_connected(void);
+bool client_alive(void);
+bool client_poll(void);
+void client_send_key(CitrusKey key, bool up);
+void client_get_view(View* view);
+
+#endif
@@ -0,0 +1,57 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FINESSE_H
+#define FINESSE_H
+
+#include <stdbool.h>
+#include "game.h"
+
+// columns of keys on each row
+#define KEY_COLUMNS 10
+// the most runs of keys a move can have before its hard drop
+#define MAX_FINESSE_STEPS 8
+
+// a key tapped count times, or held down for hold_ticks ticks to slide the
+// piece to the wall
+typedef struct {
+	CitrusKey key;
+	int count;
+	int hold_ticks;
+} FinesseStep;
+
+// The fewest key presses that take a piece from where it spawns to a
+// rotation and column, found by trying them in libcitrus. shape is the
+// piece's cells as bits of a 4x4 box, bit y * 4 + x, and x is the column
+// of the box's left edge.
+typedef struct {
+	bool found;
+	int n_steps;
+	FinesseStep steps[MAX_FINESSE_STEPS];
+	int shape;
+	int x;
+} FinesseMove;
+
+extern FinesseMove finesse_table[N_PIECES][4][KEY_COLUMNS];
+
+bool init_finesse(void);
+int check_finesse(int* n_moves);
+void free_finesse(void);
+
+#endif
@@ -0,0 +1,34 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FONT_H
+#define FONT_H
+
+// The built in font covers printable ASCII, which is everything the HUD
+// prints. Each glyph is FONT_WIDTH by FONT_HEIGHT pixels, one cell.
+#define FONT_WIDTH 10
+#define FONT_HEIGHT 20
+#define FONT_FIRST ' '
+#define FONT_LAST '~'
+#define FONT_GLYPHS (FONT_LAST - FONT_FIRST + 1)
+
+// rows of coverage from '.' (none) through '1' to 'f' (full)
+extern const char font_glyphs[FONT_GLYPHS][FONT_HEIGHT][FONT_WIDTH + 1];
+
+#endif
@@ -0,0 +1,129 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAME_H
+#define GAME_H
+
+#include "backend.h"
+#include "citrus.h"
+
+#define HUD_LINES 4
+#define OPPONENT_HUD_LINES 4
+#define HUD_LINE_SIZE 64
+#define ACTION_TEXT_SIZE 128
+#define N_PRESETS 3
+#define N_PIECES 7
+#define MAX_TARGET_COLUMNS 40
+#define MAX_TARGET_ROWS 50
+#define MAX_BOARD_CELLS (1 << 20)
+#define MAX_QUEUE_SIZE 64
+
+typedef struct {
+	const char* name;
+	const CitrusGameConfig* config;
+} Preset;
+
+extern Backend backend;
+extern Backend headless_backend;
+
+// everything that is drawn by update()
+typedef struct View View;
+
+struct View {
+	const CitrusCell* board;
+	const CitrusPiece* hold_piece;
+	const CitrusPiece** next_pieces;
+	int score;
+	int level;
+	int lines;
+	int pieces;
+	int ticks;
+	// lines of garbage sent
+	int attack;
+	// the last action text, which is drawn when its count changes
+	const char* action_text;
+	int action_text_count;
+	// the other board in a versus game, or NULL
+	const View* opponent;
+};
+
+// How txtris connects the game to the network, replays and profiling,
+// without the game depending on them, so that tools only link the game.
+// Any of them can be left NULL.
+typedef struct {
+	// returns true if the key was taken somewhere else, like a server,
+	// instead of being pressed in the local game
+	bool (*send_key)(CitrusKey key, bool up);
+	// fills in the view to draw, instead of the local game's
+	void (*get_view)(View* view);
+	// draws the stats overlay from a HUD line onwards, returning true if
+	// anything changed
+	bool (*draw_stats)(int line);
+	// told how long each frame took to flush
+	void (*flushed)(double start, double end);
+} GameHooks;
+
+extern const Preset presets[N_PRESETS];
+extern const CitrusPiece** next_piece_queue;
+extern CitrusGameConfig config;
+extern CitrusCell* board;
+extern CitrusGame game;
+extern void* randomizer;
+extern Window board_win, next_piece_win, hold_win, minimap_win, opponent_win;
+extern const CitrusPiece* pieces_by_id[N_PIECES];
+extern CitrusCell cells_by_color[N_PIECES + 2];
+extern int pieces;
+extern int ticks;
+extern int attack;
+extern const View* opponent_view;
+// the corner of the board that the viewport starts at
+extern int view_x;
+extern int view_y;
+extern int tick_rate;
+extern bool show_stats;
+extern bool show_minimap;
+extern bool show_action_text;
+extern char action_text[ACTION_TEXT_SIZE];
+extern int action_text_count;
+extern GameHooks game_hooks;
+
+void init_citrus(unsigned int seed);
+void free_citrus(void);
+bool valid_key(int key);
+bool valid_board_size(long long width, long long full_height, long long next_piece_queue_size);
+void game_key_down(CitrusKey key);
+void game_key_up(CitrusKey key);
+void init_windows(void);
+void init_piece_table(void);
+int piece_id(const CitrusPiece* piece);
+int cell_color(CitrusCell cell);
+int clear_attack(int n_lines_cleared, int combo, bool b2b, bool all_clear, bool spin);
+void resize(void);
+void get_game_view(View* view);
+void draw_view(const View* view);
+bool update_hud_line(int line, const char* fmt, ...);
+void update(void);
+void invalidate_frame(void);
+void print_action_text(const char* fmt, ...);
+void blank_board(void);
+void print_board_line(int line, const char* fmt, ...);
+void set_action_text(const char* fmt, ...);
+double now(void);
+
+#endif
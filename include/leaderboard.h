@@ -0,0 +1,53 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define LEADERBOARD_NAME_SIZE 24
+#define NO_REPLAY UINT64_MAX
+
+// one finished game, exactly as it is stored in the file
+typedef struct {
+	char player[LEADERBOARD_NAME_SIZE];
+	uint32_t config_hash;
+	int32_t score;
+	int32_t lines;
+	int32_t pieces;
+	int32_t ticks;
+	float pps;
+	int64_t time;
+	// where the replay's path is in the replay list, or NO_REPLAY
+	uint64_t replay_offset;
+} LeaderboardRecord;
+
+uint32_t leaderboard_config_hash(void);
+bool leaderboard_open(const char* path);
+bool leaderboard_add(LeaderboardRecord* record, const char* replay_path, int* rank);
+int leaderboard_top(uint32_t config_hash, int n, LeaderboardRecord* records);
+int leaderboard_player(const char* player, uint32_t config_hash, int n, LeaderboardRecord* records);
+long leaderboard_count(void);
+bool leaderboard_replay_path(const LeaderboardRecord* record, char* path, size_t size);
+void leaderboard_close(void);
+
+#endif
@@ -0,0 +1,72 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef NET_H
+#define NET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Every message is a type byte and a varint payload length, followed by the
+// payload. Numbers in payloads are varints unless noted otherwise.
+typedef enum {
+	// client to server
+	MSG_JOIN,      // room
+	MSG_KEY,       // one byte: key, with the top bit set for release
+	// server to client
+	MSG_CONFIG,    // width, full height, next queue size, player number
+	MSG_BOARD,     // pairs of (unchanged cells to skip, color)
+	MSG_STATE,     // hold and next piece ids (bytes), score, level, lines, pieces, ticks
+	MSG_ATTACK,    // sending player, lines of garbage
+	MSG_GAME_OVER, // no payload
+} MessageType;
+
+#define NO_PIECE 255
+#define MAX_MESSAGE_SIZE (1 << 24)
+
+typedef struct {
+	unsigned char* data;
+	size_t size;
+	size_t capacity;
+} Buffer;
+
+void buffer_append(Buffer* buffer, const void* data, size_t size);
+void buffer_consume(Buffer* buffer, size_t size);
+void buffer_free(Buffer* buffer);
+void put_byte(Buffer* buffer, int byte);
+void put_varint(Buffer* buffer, uint64_t value);
+size_t message_begin(Buffer* buffer, MessageType type);
+void message_end(Buffer* buffer, size_t start);
+
+typedef struct {
+	int type;
+	const unsigned char* data;
+	const unsigned char* end;
+} Message;
+
+bool next_message(Buffer* buffer, size_t* offset, Message* message);
+int get_byte(Message* message);
+uint64_t get_varint(Message* message);
+
+int net_listen(const char* address);
+int net_connect(const char* address);
+void set_nonblocking(int fd);
+
+#endif
@@ -0,0 +1,52 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+
+typedef enum {
+	PHASE_WAIT,
+	PHASE_INPUT,
+	PHASE_TICK,
+	PHASE_UPDATE,
+	PHASE_FLUSH,
+	N_PHASES
+} Phase;
+
+typedef struct {
+	int count;
+	double p50;
+	double p99;
+	double max;
+} PhaseStats;
+
+extern bool profiling;
+extern const char* phase_names[N_PHASES];
+
+bool profile_start(const char* trace_path);
+void profile_set_thread(int thread);
+void profile_record(Phase phase, double start, double end);
+void profile_startup(double start, double init_end, double first_frame);
+void profile_get_stats(Phase phase, bool recent, PhaseStats* stats);
+void profile_report(void);
+void profile_stop(void);
+
+#endif
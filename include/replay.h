@@ -0,0 +1,48 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdbool.h>
+#include "citrus.h"
+
+// where playback is in a replay, so that it can be rewound with the game
+typedef struct {
+	long offset;
+	int tick;
+	int key;
+	bool up;
+	bool ended;
+} ReplayCursor;
+
+extern bool replaying;
+
+bool replay_record_start(const char* path, int preset, unsigned int seed);
+void replay_record_key(CitrusKey key, bool up);
+void replay_record_end(void);
+bool replay_open(const char* path, unsigned int* seed);
+void replay_apply(void);
+bool replay_finished(void);
+bool replay_verify(void);
+void replay_get_cursor(ReplayCursor* cursor);
+void replay_set_cursor(const ReplayCursor* cursor);
+void replay_close(void);
+
+#endif
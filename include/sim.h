@@ -0,0 +1,88 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include "citrus.h"
+
+// A game run by the simulator. These are allocated together with their
+// boards and queues in one arena per worker thread.
+typedef struct {
+	CitrusGame game;
+	union {
+		CitrusBagRandomizer bag;
+		CitrusClassicRandomizer classic;
+	} randomizer;
+	CitrusCell* board;
+	const CitrusPiece** next_piece_queue;
+	uint32_t rng;
+	int pieces;
+	int ticks;
+	int lines;
+	int attack;
+	// lines cleared by the last piece
+	int last_clear;
+	int games;
+	void* data;
+} SimGame;
+
+// Called for every game before each tick, to press keys.
+typedef void (*SimPolicy)(SimGame* game, int worker);
+// Called when a game ends or reaches max_pieces, just before it is
+// restarted.
+typedef void (*SimGameOver)(SimGame* game, int worker);
+
+typedef struct {
+	SimGame* games;
+	int n_games;
+	atomic_int next_chunk;
+	void* arena;
+	double busy_time;
+	// keep shards that are written to by different threads apart
+	char padding[64];
+} SimShard;
+
+typedef struct {
+	CitrusGameConfig config;
+	int n_workers;
+	int n_games;
+	unsigned int seed;
+	SimPolicy policy;
+	SimGameOver game_over;
+	SimShard* shards;
+	pthread_t* threads;
+	pthread_barrier_t start;
+	pthread_barrier_t done;
+	int step_ticks;
+	// games are restarted after this many pieces, if it isn't 0
+	int max_pieces;
+	bool quit;
+	long long total_ticks;
+	double step_time;
+} Sim;
+
+void sim_init(Sim* sim, CitrusGameConfig config, int n_games, int n_workers, unsigned int seed, SimPolicy policy, SimGameOver game_over);
+void sim_step(Sim* sim, int n_ticks);
+void sim_free(Sim* sim);
+
+#endif
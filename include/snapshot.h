@@ -0,0 +1,45 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// A snapshot is the whole state of the local game as a block of bytes. It
+// can only be loaded back into the game it was taken from, since the game
+// has pointers to its board, queue and randomizer.
+size_t snapshot_size(void);
+void snapshot_save(unsigned char* buffer);
+void snapshot_load(const unsigned char* buffer);
+
+bool lookahead_start(void);
+int ticks_until_change(int limit);
+int falling_piece(void);
+void lookahead_stop(void);
+
+bool rewind_start(int max_ticks, size_t memory, int keyframe_interval);
+void rewind_push(void);
+int rewind_available(void);
+int rewind_back(int n_ticks);
+size_t rewind_memory_used(void);
+void rewind_stop(void);
+
+#endif
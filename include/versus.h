@@ -0,0 +1,36 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERSUS_H
+#define VERSUS_H
+
+#include <stdbool.h>
+#include "game.h"
+
+extern bool versus;
+extern double bot_pps;
+extern double bot_budget;
+
+void versus_start(unsigned int seed);
+void versus_tick(void);
+bool versus_bot_alive(void);
+void versus_report(void);
+void versus_stop(void);
+
+#endif
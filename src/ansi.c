@@ -0,0 +1,436 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <unistd.h>
+#include "ansi.h"
+#include "backend.h"
+#include "citrus.h"
+#include "game.h"
+
+// Draws straight to the terminal with escape sequences, without ncurses.
+// Everything is drawn into a copy of the screen, and each frame only the
+// cells that differ from what the terminal is showing are sent, with runs of
+// the same color sharing one color change, in a single write. While the
+// terminal's output queue is backed up, frames are held back and merged
+// into the next one, so a slow connection gets fewer frames instead of
+// falling further and further behind. The screens are kept apart from the
+// terminal they belong to, so that the host draws each telnet session's
+// terminal with the same calls.
+
+#define MAX_BACKLOG 4096
+// rewriting a few unchanged cells is cheaper than moving the cursor
+#define MAX_GAP 4
+#define PENDING_POLL 0.01
+
+// color, rgb, 4-bit color, 8-bit color
+const int ansi_colors[7][6] = {
+	{CITRUS_COLOR_I, 89, 154, 209, 6, 45},
+	{CITRUS_COLOR_J, 55, 67, 190, 4, 21},
+	{CITRUS_COLOR_L, 202, 99, 41, 3, 166},
+	{CITRUS_COLOR_O, 253, 255, 12, 3, 226},
+	{CITRUS_COLOR_S, 117, 174, 54, 2, 118},
+	{CITRUS_COLOR_T, 155, 55, 134, 5, 129},
+	{CITRUS_COLOR_Z, 188, 46, 61, 1, 160},
+};
+
+pthread_mutex_t ansi_mutex = PTHREAD_MUTEX_INITIALIZER;
+struct termios saved_termios;
+volatile sig_atomic_t resized = 0;
+AnsiScreen stdout_screen;
+AnsiScreen* ansi_screen = &stdout_screen;
+bool frame_pending = false;
+unsigned char key_buffer[64];
+int key_buffer_length = 0;
+double key_time = 0;
+
+void restore_terminal(void) {
+	const char reset[] = "\033[0m\033[?25h\033[?1049l";
+	if (write(STDOUT_FILENO, reset, sizeof(reset) - 1) < 0)
+		return;
+	tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved_termios);
+}
+
+void handle_winch(int signal) {
+	(void) signal;
+	resized = 1;
+}
+
+void handle_exit_signal(int sig) {
+	restore_terminal();
+	signal(sig, SIG_DFL);
+	raise(sig);
+}
+
+bool env_contains(const char* name, const char* s) {
+	const char* value = getenv(name);
+	return value != NULL && strstr(value, s) != NULL;
+}
+
+void ansi_screen_init(AnsiScreen* screen, bool truecolor, bool colors_256, bool unicode_boxes) {
+	*screen = (AnsiScreen) {.color = -1, .unicode_boxes = unicode_boxes};
+	ansi_screen_set_colors(screen, truecolor, colors_256);
+}
+
+void ansi_screen_set_colors(AnsiScreen* screen, bool truecolor, bool colors_256) {
+	strcpy(screen->color_codes[0], "\033[49m");
+	strcpy(screen->color_codes[1], "\033[47m");
+	for (int i = 0; i < 7; i++) {
+		char* code = screen->color_codes[ansi_colors[i][0] + 2];
+		if (truecolor)
+			sprintf(code, "\033[48;2;%i;%i;%im", ansi_colors[i][1], ansi_colors[i][2], ansi_colors[i][3]);
+		else if (colors_256)
+			sprintf(code, "\033[48;5;%im", ansi_colors[i][5]);
+		else
+			sprintf(code, "\033[4%im", ansi_colors[i][4]);
+	}
+}
+
+void ansi_init(void) {
+	tcgetattr(STDIN_FILENO, &saved_termios);
+	struct termios raw = saved_termios;
+	raw.c_lflag &= ~(ICANON | ECHO);
+	raw.c_cc[VMIN] = 0;
+	raw.c_cc[VTIME] = 0;
+	tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+	struct sigaction action = {0};
+	action.sa_handler = handle_winch;
+	sigaction(SIGWINCH, &action, NULL);
+	action.sa_handler = handle_exit_signal;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	const char* locale = getenv("LC_ALL");
+	if (locale == NULL || *locale == '\0')
+		locale = getenv("LC_CTYPE");
+	if (locale == NULL || *locale == '\0')
+		locale = getenv("LANG");
+	bool unicode_boxes = locale != NULL && (strstr(locale, "UTF-8") || strstr(locale, "utf8") || strstr(locale, "UTF8") || strstr(locale, "utf-8"));
+	bool truecolor = env_contains("COLORTERM", "truecolor") || env_contains("COLORTERM", "24bit");
+	bool colors_256 = env_contains("TERM", "256color");
+	ansi_screen_init(&stdout_screen, truecolor, colors_256, unicode_boxes);
+	ansi_screen = &stdout_screen;
+	const char start[] = "\033[?1049h\033[?25l";
+	if (write(STDOUT_FILENO, start, sizeof(start) - 1) < 0)
+		perror("write");
+}
+
+void ansi_exit(void) {
+	restore_terminal();
+	ansi_screen_free(&stdout_screen);
+}
+
+void ansi_screen_free(AnsiScreen* screen) {
+	free(screen->cells);
+	free(screen->shown);
+	free(screen->frame);
+	screen->cells = screen->shown = NULL;
+	screen->frame = NULL;
+	screen->width = screen->height = 0;
+	screen->frame_capacity = 0;
+}
+
+void ansi_lock(void) {
+	pthread_mutex_lock(&ansi_mutex);
+}
+
+void ansi_unlock(void) {
+	pthread_mutex_unlock(&ansi_mutex);
+}
+
+void frame_append(AnsiScreen* screen, const char* s, size_t size) {
+	if (screen->frame_size + size > screen->frame_capacity) {
+		screen->frame_capacity = (screen->frame_size + size) * 2;
+		screen->frame = realloc(screen->frame, screen->frame_capacity);
+	}
+	memcpy(screen->frame + screen->frame_size, s, size);
+	screen->frame_size += size;
+}
+
+void frame_append_char(AnsiScreen* screen, uint32_t ch) {
+	char utf8[4];
+	if (ch < 0x80) {
+		utf8[0] = ch;
+		frame_append(screen, utf8, 1);
+	} else if (ch < 0x800) {
+		utf8[0] = 0xc0 | ch >> 6;
+		utf8[1] = 0x80 | (ch & 0x3f);
+		frame_append(screen, utf8, 2);
+	} else {
+		utf8[0] = 0xe0 | ch >> 12;
+		utf8[1] = 0x80 | (ch >> 6 & 0x3f);
+		utf8[2] = 0x80 | (ch & 0x3f);
+		frame_append(screen, utf8, 3);
+	}
+}
+
+bool cell_changed(const AnsiScreen* screen, int i) {
+	return screen->cells[i].ch != screen->shown[i].ch || screen->cells[i].color != screen->shown[i].color;
+}
+
+// Puts everything that changed since the last frame into the screen's
+// frame, and takes it as shown.
+void ansi_screen_compose(AnsiScreen* screen) {
+	screen->frame_size = 0;
+	if (screen->clear_pending) {
+		const char clear[] = "\033[49m\033[2J";
+		frame_append(screen, clear, sizeof(clear) - 1);
+		screen->color = 0;
+		screen->clear_pending = false;
+	}
+	int width = screen->width;
+	for (int y = 0; y < screen->height; y++) {
+		ScreenCell* row = screen->cells + y * width;
+		int x = 0;
+		while (x < width) {
+			if (!cell_changed(screen, y * width + x)) {
+				x++;
+				continue;
+			}
+			int end = x;
+			for (int i = x; i < width && i - end <= MAX_GAP; i++) {
+				if (cell_changed(screen, y * width + i))
+					end = i;
+			}
+			char move[32];
+			int size = snprintf(move, sizeof(move), "\033[%i;%iH", y + 1, x + 1);
+			frame_append(screen, move, size);
+			for (; x <= end; x++) {
+				if (row[x].color != screen->color) {
+					screen->color = row[x].color;
+					const char* code = screen->color_codes[screen->color];
+					frame_append(screen, code, strlen(code));
+				}
+				frame_append_char(screen, row[x].ch);
+				screen->shown[y * width + x] = row[x];
+			}
+		}
+	}
+}
+
+// Sends everything that changed since the last frame, unless the terminal
+// is still busy with earlier frames. Returns false if the frame was held
+// back.
+bool flush_frame(void) {
+	int queued = 0;
+	if (ioctl(STDOUT_FILENO, TIOCOUTQ, &queued) == 0 && queued > MAX_BACKLOG)
+		return false;
+	AnsiScreen* screen = &stdout_screen;
+	ansi_screen_compose(screen);
+	size_t written = 0;
+	while (written < screen->frame_size) {
+		ssize_t n = write(STDOUT_FILENO, screen->frame + written, screen->frame_size - written);
+		if (n <= 0)
+			break;
+		written += n;
+	}
+	frame_pending = false;
+	return true;
+}
+
+// This runs on the input thread. It also sends frames that were held back,
+// once the terminal has caught up.
+KeyType ansi_get_key(double timeout, int* key, double* time) {
+	ansi_lock();
+	if (frame_pending)
+		flush_frame();
+	bool pending = frame_pending;
+	ansi_unlock();
+	if (key_buffer_length == 0 && !resized) {
+		if (pending && timeout > PENDING_POLL)
+			timeout = PENDING_POLL;
+		fd_set fds;
+		FD_ZERO(&fds);
+		FD_SET(STDIN_FILENO, &fds);
+		struct timespec t = {timeout, (timeout - (long) timeout) * 1e9};
+		if (pselect(STDIN_FILENO + 1, &fds, NULL, NULL, &t, NULL) > 0) {
+			key_time = now();
+			ssize_t n = read(STDIN_FILENO, key_buffer, sizeof(key_buffer));
+			if (n > 0)
+				key_buffer_length = n;
+		}
+	}
+	*time = key_time;
+	if (resized) {
+		resized = 0;
+		*time = now();
+		*key = K_RESIZE;
+		return KEYTYPE_PRESS;
+	}
+	if (key_buffer_length == 0)
+		return KEYTYPE_NONE;
+	int used = 1;
+	*key = key_buffer[0];
+	if (key_buffer[0] == '\033' && key_buffer_length >= 3 && (key_buffer[1] == '[' || key_buffer[1] == 'O')) {
+		used = 3;
+		switch (key_buffer[2]) {
+			case 'A': *key = K_UP; break;
+			case 'B': *key = K_DOWN; break;
+			case 'C': *key = K_RIGHT; break;
+			case 'D': *key = K_LEFT; break;
+			default: *key = -1;
+		}
+	}
+	key_buffer_length -= used;
+	memmove(key_buffer, key_buffer + used, key_buffer_length);
+	return *key == -1 ? KEYTYPE_NONE : KEYTYPE_PRESS;
+}
+
+void put_cell(int x, int y, uint32_t ch, int color) {
+	AnsiScreen* screen = ansi_screen;
+	if (x < 0 || y < 0 || x >= screen->width || y >= screen->height)
+		return;
+	screen->cells[y * screen->width + x] = (ScreenCell) {ch, color};
+}
+
+void blank(int x, int y, int width, int height) {
+	for (int i = y; i < y + height; i++) {
+		for (int j = x; j < x + width; j++)
+			put_cell(j, i, ' ', 0);
+	}
+}
+
+void ansi_init_window(Window* window) {
+	(void) window;
+}
+
+void ansi_resize_window(Window* window) {
+	(void) window;
+}
+
+void ansi_full_update(void) {
+	frame_pending = true;
+	flush_frame();
+}
+
+void ansi_update(Window window) {
+	(void) window;
+}
+
+void ansi_print(int y, int x, const char* format, ...) {
+	char text[256];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(text, sizeof(text), format, args);
+	va_end(args);
+	for (int i = 0; text[i] != '\0'; i++)
+		put_cell(x + i, y, (unsigned char) text[i], 0);
+}
+
+void ansi_erase_window(Window window) {
+	blank(window.x, window.y, window.width, window.height);
+}
+
+void ansi_erase_line(int x, int y) {
+	blank(x, y, ansi_screen->width - x, 1);
+}
+
+void ansi_clear_screen(void) {
+	blank(0, 0, ansi_screen->width, ansi_screen->height);
+}
+
+void ansi_draw_cell(Window window, int x, int y, int color) {
+	put_cell(window.x + x, window.y + y, ' ', color);
+	put_cell(window.x + x + 1, window.y + y, ' ', color);
+}
+
+void ansi_draw_box(Window window) {
+	int left = window.x, right = window.x + window.width - 1;
+	int top = window.y, bottom = window.y + window.height - 1;
+	bool unicode_boxes = ansi_screen->unicode_boxes;
+	uint32_t horizontal = unicode_boxes ? 0x2500 : '-';
+	uint32_t vertical = unicode_boxes ? 0x2502 : '|';
+	for (int x = left + 1; x < right; x++) {
+		put_cell(x, top, horizontal, 0);
+		put_cell(x, bottom, horizontal, 0);
+	}
+	for (int y = top + 1; y < bottom; y++) {
+		put_cell(left, y, vertical, 0);
+		put_cell(right, y, vertical, 0);
+	}
+	put_cell(left, top, unicode_boxes ? 0x250c : '+', 0);
+	put_cell(right, top, unicode_boxes ? 0x2510 : '+', 0);
+	put_cell(left, bottom, unicode_boxes ? 0x2514 : '+', 0);
+	put_cell(right, bottom, unicode_boxes ? 0x2518 : '+', 0);
+}
+
+void ansi_get_size(int* width, int* height) {
+	struct winsize size;
+	if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) < 0 || size.ws_col == 0) {
+		size.ws_col = 80;
+		size.ws_row = 24;
+	}
+	ansi_screen_resize(&stdout_screen, size.ws_col, size.ws_row);
+	*width = stdout_screen.width;
+	*height = stdout_screen.height;
+}
+
+void ansi_screen_resize(AnsiScreen* screen, int width, int height) {
+	if (width == screen->width && height == screen->height && screen->cells != NULL)
+		return;
+	screen->width = width;
+	screen->height = height;
+	screen->cells = realloc(screen->cells, sizeof(ScreenCell) * width * height);
+	screen->shown = realloc(screen->shown, sizeof(ScreenCell) * width * height);
+	// the terminal may have moved things around, so start again from a
+	// blank screen
+	for (int i = 0; i < width * height; i++)
+		screen->cells[i] = (ScreenCell) {' ', 0};
+	ansi_screen_clear(screen);
+}
+
+// clears the terminal with the next frame, which then redraws everything
+void ansi_screen_clear(AnsiScreen* screen) {
+	for (int i = 0; i < screen->width * screen->height; i++)
+		screen->shown[i] = (ScreenCell) {' ', 0};
+	screen->clear_pending = true;
+}
+
+void ansi_set_target_size(int width, int height) {
+	(void) width; (void) height;
+}
+
+Backend ansi_backend = {
+	.init = ansi_init,
+	.exit = ansi_exit,
+	.get_key = ansi_get_key,
+	.init_window = ansi_init_window,
+	.resize_window = ansi_resize_window,
+	.full_update = ansi_full_update,
+	.update = ansi_update,
+	.print = ansi_print,
+	.erase_window = ansi_erase_window,
+	.erase_line = ansi_erase_line,
+	.clear_screen = ansi_clear_screen,
+	.draw_cell = ansi_draw_cell,
+	.draw_box = ansi_draw_box,
+	.get_size = ansi_get_size,
+	.set_target_size = ansi_set_target_size,
+	.threaded_input = true,
+	.lock = ansi_lock,
+	.unlock = ansi_unlock,
+};
@@ -0,0 +1,387 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "game.h"
+#include "leaderboard.h"
+#include "net.h"
+#include "sim.h"
+#include "snapshot.h"
+
+typedef struct {
+	CitrusKey key;
+	int delay;
+} ScriptStep;
+
+// a fixed cycle of placements, roughly what a slow player would do
+const ScriptStep script[] = {
+	{CITRUS_KEY_LEFT, 3}, {CITRUS_KEY_LEFT, 3}, {CITRUS_KEY_LEFT, 3}, {CITRUS_KEY_HARD_DROP, 8},
+	{CITRUS_KEY_CLOCKWISE, 4}, {CITRUS_KEY_RIGHT, 3}, {CITRUS_KEY_RIGHT, 3}, {CITRUS_KEY_HARD_DROP, 8},
+	{CITRUS_KEY_HOLD, 4}, {CITRUS_KEY_ANTICLOCKWISE, 4}, {CITRUS_KEY_SOFT_DROP, 20}, {CITRUS_KEY_HARD_DROP, 8},
+	{CITRUS_KEY_180, 4}, {CITRUS_KEY_RIGHT, 3}, {CITRUS_KEY_HARD_DROP, 8},
+	{CITRUS_KEY_LEFT, 3}, {CITRUS_KEY_HARD_DROP, 8},
+};
+const int script_length = sizeof(script) / sizeof(script[0]);
+
+const char* program_name;
+long long n_ticks = 1000000;
+unsigned int seed = 1;
+bool random_input = false;
+const char* server_address = NULL;
+int n_clients = 100;
+int n_games = 0;
+int n_threads = 1;
+double load_test_time = 10;
+long n_records = 0;
+uint32_t rng_state;
+
+uint32_t bench_random(void) {
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+void press(CitrusKey key) {
+	CitrusGame_key_down(&game, key);
+	CitrusGame_key_up(&game, key);
+}
+
+// Runs games with a scripted or random player. With render, every tick is
+// drawn with the headless backend, and with rewind, every tick is pushed
+// into the rewind buffer, which is also seeked now and then.
+void run(const Preset* preset, bool render, bool rewind) {
+	long long total_pieces = 0;
+	int games = 1;
+	int step = 0;
+	int delay = 0;
+	unsigned int game_seed = seed;
+	config = *preset->config;
+	rng_state = seed | 1;
+	init_citrus(game_seed);
+	init_windows();
+	if (rewind)
+		rewind_start(36000, 32 << 20, 60);
+	int seeks = 0;
+	int seek_ticks = 0;
+	double seek_time = 0;
+	double stored_bytes = 0;
+	double stored_ticks = 0;
+	double start = now();
+	for (long long i = 0; i < n_ticks; i++) {
+		if (random_input) {
+			uint32_t r = bench_random();
+			if ((r & 3) == 0) {
+				// weight hard drops so that pieces keep coming
+				int key = (r >> 2) % 10;
+				press(key >= 8 ? CITRUS_KEY_HARD_DROP : (CitrusKey) key);
+			}
+		} else if (delay-- <= 0) {
+			press(script[step].key);
+			delay = script[step].delay;
+			step = (step + 1) % script_length;
+		}
+		CitrusGame_tick(&game);
+		ticks++;
+		if (render)
+			update();
+		if (rewind) {
+			rewind_push();
+			if (i % 1000 == 999 && rewind_available() > 0) {
+				double seek_start = now();
+				seek_ticks += rewind_back(bench_random() % rewind_available() + 1);
+				seek_time += now() - seek_start;
+				seeks++;
+			}
+		}
+		if (!CitrusGame_is_alive(&game)) {
+			total_pieces += pieces;
+			if (rewind) {
+				stored_bytes += rewind_memory_used();
+				stored_ticks += rewind_available() + 1;
+				rewind_stop();
+			}
+			free_citrus();
+			init_citrus(++game_seed);
+			if (rewind)
+				rewind_start(36000, 32 << 20, 60);
+			games++;
+		}
+	}
+	double elapsed = now() - start;
+	total_pieces += pieces;
+	stored_bytes += rewind_memory_used();
+	stored_ticks += rewind_available() + 1;
+	rewind_stop();
+	free_citrus();
+	printf("%-10s %-7s %12.0f %12.0f %10.1f %8i\n", preset->name, render ? "update" : rewind ? "rewind" : "engine",
+		n_ticks / elapsed, total_pieces / elapsed, elapsed * 1e9 / n_ticks, games);
+	if (rewind && seeks > 0) {
+		printf("%-10s %i seeks of %.0f ticks on average, %.1f us each, %.0f bytes per tick stored\n", "",
+			seeks, (double) seek_ticks / seeks, seek_time * 1e6 / seeks, stored_bytes / stored_ticks);
+	}
+}
+
+void random_policy(SimGame* game, int worker) {
+	(void) worker;
+	game->rng ^= game->rng << 13;
+	game->rng ^= game->rng >> 17;
+	game->rng ^= game->rng << 5;
+	if ((game->rng & 3) == 0) {
+		int key = (game->rng >> 2) % 10;
+		CitrusKey k = key >= 8 ? CITRUS_KEY_HARD_DROP : (CitrusKey) key;
+		CitrusGame_key_down(&game->game, k);
+		CitrusGame_key_up(&game->game, k);
+	}
+}
+
+// Steps many games at once on a pool of threads.
+void run_many(void) {
+	Sim sim;
+	config = citrus_preset_modern;
+	sim_init(&sim, config, n_games, n_threads, seed, random_policy, NULL);
+	const int step = 60;
+	long long steps = (n_ticks + step - 1) / step;
+	double worst = 0;
+	for (long long i = 0; i < steps; i++) {
+		double start = now();
+		sim_step(&sim, step);
+		double t = (now() - start) / step;
+		if (t > worst)
+			worst = t;
+	}
+	double per_tick = sim.step_time / sim.total_ticks;
+	printf("%i games on %i threads: %.1f us per tick (worst %.1f us), %.0f game ticks/s\n",
+		n_games, n_threads, per_tick * 1e6, worst * 1e6, n_games / per_tick);
+	for (int i = 0; i < n_threads; i++)
+		printf("thread %i: %.0f%% busy\n", i, sim.shards[i].busy_time / sim.step_time * 100);
+	sim_free(&sim);
+}
+
+// Fills a leaderboard in a temporary file with made up games from a few
+// thousand players, then times adding games and querying it.
+void leaderboard_test(void) {
+	char path[] = "/tmp/txtris-bench-XXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0 || !leaderboard_open(path)) {
+		perror(path);
+		exit(-1);
+	}
+	close(fd);
+	rng_state = seed;
+	uint32_t hashes[2] = {leaderboard_config_hash(), leaderboard_config_hash() ^ 1};
+	double start = now();
+	for (long i = 0; i < n_records; i++) {
+		LeaderboardRecord record = {0};
+		snprintf(record.player, sizeof(record.player), "player%u", bench_random() % 5000);
+		record.config_hash = hashes[bench_random() % 2];
+		record.score = bench_random() % 1000000;
+		record.lines = record.score / 1000;
+		record.ticks = bench_random() % 100000;
+		if (!leaderboard_add(&record, NULL, NULL)) {
+			fprintf(stderr, "%s: can't add to leaderboard\n", program_name);
+			exit(-1);
+		}
+	}
+	double add_time = now() - start;
+	int queries = 100000;
+	LeaderboardRecord records[10];
+	start = now();
+	for (int i = 0; i < queries; i++)
+		leaderboard_top(hashes[i % 2], 10, records);
+	double top_time = now() - start;
+	start = now();
+	for (int i = 0; i < queries; i++) {
+		char player[LEADERBOARD_NAME_SIZE];
+		snprintf(player, sizeof(player), "player%u", bench_random() % 5000);
+		leaderboard_player(player, hashes[i % 2], 10, records);
+	}
+	double player_time = now() - start;
+	leaderboard_close();
+	start = now();
+	if (!leaderboard_open(path)) {
+		perror(path);
+		exit(-1);
+	}
+	double open_time = now() - start;
+	leaderboard_close();
+	const char* suffixes[] = {"", ".scores", ".players", ".replays"};
+	for (int i = 0; i < 4; i++) {
+		char file[64];
+		snprintf(file, sizeof(file), "%s%s", path, suffixes[i]);
+		unlink(file);
+	}
+	printf("%li records: %.1f us per add, %.2f us per top 10, %.2f us per player's top 10, %.1f us to open\n",
+		n_records, add_time / n_records * 1e6, top_time / queries * 1e6, player_time / queries * 1e6, open_time * 1e6);
+}
+
+// Connects players to a server over loopback and has them press random
+// keys, to see how many games a server can host.
+void load_test(void) {
+	int* fds = malloc(sizeof(int) * n_clients);
+	Buffer* inputs = calloc(n_clients, sizeof(Buffer));
+	for (int i = 0; i < n_clients; i++) {
+		fds[i] = net_connect(server_address);
+		if (fds[i] < 0) {
+			fprintf(stderr, "%s: can't connect to %s\n", program_name, server_address);
+			exit(-1);
+		}
+		Buffer join = {0};
+		size_t start = message_begin(&join, MSG_JOIN);
+		put_varint(&join, i / 2);
+		message_end(&join, start);
+		send(fds[i], join.data, join.size, 0);
+		buffer_free(&join);
+		set_nonblocking(fds[i]);
+	}
+	long long bytes = 0, messages = 0, keys = 0;
+	int finished = 0;
+	rng_state = seed | 1;
+	double start = now();
+	double next_tick = start;
+	while (now() - start < load_test_time) {
+		for (int i = 0; i < n_clients; i++) {
+			if (fds[i] < 0)
+				continue;
+			uint32_t r = bench_random();
+			if ((r & 7) == 0) {
+				int key = (r >> 3) % 10;
+				Buffer press = {0};
+				for (int up = 0; up < 2; up++) {
+					size_t m = message_begin(&press, MSG_KEY);
+					put_byte(&press, (key >= 8 ? CITRUS_KEY_HARD_DROP : key) | (up ? 0x80 : 0));
+					message_end(&press, m);
+				}
+				send(fds[i], press.data, press.size, MSG_NOSIGNAL);
+				buffer_free(&press);
+				keys++;
+			}
+			unsigned char buffer[4096];
+			ssize_t n;
+			while ((n = recv(fds[i], buffer, sizeof(buffer), 0)) > 0) {
+				bytes += n;
+				buffer_append(&inputs[i], buffer, n);
+			}
+			size_t offset = 0;
+			Message message;
+			bool over = n == 0;
+			while (next_message(&inputs[i], &offset, &message)) {
+				messages++;
+				over |= message.type == MSG_GAME_OVER;
+			}
+			buffer_consume(&inputs[i], offset);
+			if (over) {
+				close(fds[i]);
+				fds[i] = -1;
+				finished++;
+			}
+		}
+		next_tick += 1.0 / 60.0;
+		double wait = next_tick - now();
+		if (wait > 0) {
+			struct timespec t = {0, wait * 1e9};
+			nanosleep(&t, NULL);
+		}
+	}
+	double elapsed = now() - start;
+	printf("%i players for %.1f s: %.0f keys/s, %.0f messages/s, %.0f bytes/s received, %i games over\n",
+		n_clients, elapsed, keys / elapsed, messages / elapsed, bytes / elapsed, finished);
+	for (int i = 0; i < n_clients; i++) {
+		if (fds[i] >= 0)
+			close(fds[i]);
+		buffer_free(&inputs[i]);
+	}
+	free(fds);
+	free(inputs);
+}
+
+int main(int argc, char** argv) {
+	program_name = argv[0];
+	int c;
+	while ((c = getopt(argc, argv, "rc:j:L:m:n:p:s:T:")) != -1) {
+		switch (c) {
+			case 'n':
+				n_ticks = strtoll(optarg, NULL, 10);
+				break;
+			case 's':
+				seed = strtoul(optarg, NULL, 10);
+				break;
+			case 'r':
+				random_input = true;
+				break;
+			case 'c':
+				server_address = optarg;
+				break;
+			case 'm':
+				n_games = strtol(optarg, NULL, 10);
+				break;
+			case 'j':
+				n_threads = strtol(optarg, NULL, 10);
+				break;
+			case 'p':
+				n_clients = strtol(optarg, NULL, 10);
+				break;
+			case 'T':
+				load_test_time = strtod(optarg, NULL);
+				break;
+			case 'L':
+				n_records = strtol(optarg, NULL, 10);
+				break;
+			case '?':
+				exit(-1);
+			default:
+				break;
+		}
+	}
+	if (n_ticks <= 0) {
+		fprintf(stderr, "%s: tick count must be positive\n", program_name);
+		exit(-1);
+	}
+	if (server_address != NULL) {
+		load_test();
+		return 0;
+	}
+	if (n_records > 0) {
+		leaderboard_test();
+		return 0;
+	}
+	if (n_games > 0) {
+		if (n_threads < 1) {
+			fprintf(stderr, "%s: thread count must be positive\n", program_name);
+			exit(-1);
+		}
+		run_many();
+		return 0;
+	}
+	backend = headless_backend;
+	backend.init();
+	printf("%-10s %-7s %12s %12s %10s %8s\n", "preset", "mode", "ticks/s", "pieces/s", "ns/tick", "games");
+	for (int i = 0; i < N_PRESETS; i++) {
+		run(&presets[i], false, false);
+		run(&presets[i], true, false);
+		run(&presets[i], false, true);
+	}
+	backend.exit();
+	return 0;
+}
@@ -0,0 +1,397 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "bitboard.h"
+#include "game.h"
+
+// Generates every place a piece can be locked in, for bots and for perft.
+// Pieces move by SRS rules: shifting, soft dropping and rotating with the
+// standard kick tables, so tucks and spins are found. A T piece locked
+// right after a rotation with three of its corners filled counts as a
+// spin. Placements that fill the same cells are only listed once, using
+// Zobrist hashes of the cells.
+
+#define MARGIN 4
+
+typedef struct {
+	int n_cells;
+	int x[16];
+	int y[16];
+	int min_x, max_x, min_y, max_y;
+	uint64_t rows[16];
+} Shape;
+
+Shape shapes[N_PIECES][4];
+int box_sizes[N_PIECES];
+uint64_t zobrist[BITBOARD_MAX_HEIGHT][BITBOARD_MAX_WIDTH];
+uint64_t zobrist_spin;
+
+// kicks for (from rotation, clockwise = 0 or anticlockwise = 1), y up
+const int jlstz_kicks[4][2][5][2] = {
+	{{{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}}, {{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}}},
+	{{{0, 0}, {1, 0}, {1, -1}, {0, 2}, {1, 2}}, {{0, 0}, {1, 0}, {1, -1}, {0, 2}, {1, 2}}},
+	{{{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}}, {{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}}},
+	{{{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}}, {{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}}},
+};
+const int i_kicks[4][2][5][2] = {
+	{{{0, 0}, {-2, 0}, {1, 0}, {-2, -1}, {1, 2}}, {{0, 0}, {-1, 0}, {2, 0}, {-1, 2}, {2, -1}}},
+	{{{0, 0}, {-1, 0}, {2, 0}, {-1, 2}, {2, -1}}, {{0, 0}, {2, 0}, {-1, 0}, {2, 1}, {-1, -2}}},
+	{{{0, 0}, {2, 0}, {-1, 0}, {2, 1}, {-1, -2}}, {{0, 0}, {1, 0}, {-2, 0}, {1, -2}, {-2, 1}}},
+	{{{0, 0}, {1, 0}, {-2, 0}, {1, -2}, {-2, 1}}, {{0, 0}, {-2, 0}, {1, 0}, {-2, -1}, {1, 2}}},
+};
+
+uint64_t splitmix(uint64_t* state) {
+	uint64_t z = (*state += 0x9e3779b97f4a7c15);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+	return z ^ (z >> 31);
+}
+
+void finish_shape(Shape* shape) {
+	shape->min_x = shape->min_y = 16;
+	shape->max_x = shape->max_y = -1;
+	for (int i = 0; i < shape->n_cells; i++) {
+		if (shape->x[i] < shape->min_x) shape->min_x = shape->x[i];
+		if (shape->x[i] > shape->max_x) shape->max_x = shape->x[i];
+		if (shape->y[i] < shape->min_y) shape->min_y = shape->y[i];
+		if (shape->y[i] > shape->max_y) shape->max_y = shape->y[i];
+	}
+	memset(shape->rows, 0, sizeof(shape->rows));
+	for (int i = 0; i < shape->n_cells; i++)
+		shape->rows[shape->y[i]] |= (uint64_t) 1 << (shape->x[i] - shape->min_x);
+}
+
+// Builds every rotation of every piece from libcitrus' pieces, which have to
+// be found with init_piece_table first.
+void init_piece_shapes(void) {
+	for (int id = 0; id < N_PIECES; id++) {
+		const CitrusPiece* piece = pieces_by_id[id];
+		if (piece == NULL)
+			continue;
+		int n = piece->width > piece->height ? piece->width : piece->height;
+		box_sizes[id] = n;
+		Shape* shape = &shapes[id][0];
+		shape->n_cells = 0;
+		for (int y = 0; y < piece->height; y++) {
+			for (int x = 0; x < piece->width; x++) {
+				if (piece->piece_data[y * piece->width + x].type == CITRUS_CELL_FULL && shape->n_cells < 16) {
+					shape->x[shape->n_cells] = x;
+					shape->y[shape->n_cells] = y;
+					shape->n_cells++;
+				}
+			}
+		}
+		finish_shape(shape);
+		for (int r = 1; r < 4; r++) {
+			Shape* prev = &shapes[id][r - 1];
+			Shape* next = &shapes[id][r];
+			next->n_cells = prev->n_cells;
+			// clockwise around the centre of the box
+			for (int i = 0; i < prev->n_cells; i++) {
+				next->x[i] = prev->y[i];
+				next->y[i] = n - 1 - prev->x[i];
+			}
+			finish_shape(next);
+		}
+	}
+	uint64_t state = 1;
+	for (int y = 0; y < BITBOARD_MAX_HEIGHT; y++) {
+		for (int x = 0; x < BITBOARD_MAX_WIDTH; x++)
+			zobrist[y][x] = splitmix(&state);
+	}
+	zobrist_spin = splitmix(&state);
+}
+
+bool bitboard_from_cells(Bitboard* bitboard, const CitrusCell* cells, int width, int height) {
+	if (width > BITBOARD_MAX_WIDTH || height > BITBOARD_MAX_HEIGHT)
+		return false;
+	bitboard->width = width;
+	bitboard->height = height;
+	for (int y = 0; y < height; y++) {
+		uint64_t row = 0;
+		for (int x = 0; x < width; x++) {
+			if (cells[y * width + x].type == CITRUS_CELL_FULL)
+				row |= (uint64_t) 1 << x;
+		}
+		bitboard->rows[y] = row;
+	}
+	return true;
+}
+
+void bitboard_to_cells(const Bitboard* bitboard, CitrusCell* cells, CitrusCell full, CitrusCell empty) {
+	for (int y = 0; y < bitboard->height; y++) {
+		for (int x = 0; x < bitboard->width; x++)
+			cells[y * bitboard->width + x] = (bitboard->rows[y] >> x & 1) ? full : empty;
+	}
+}
+
+bool collides(const Bitboard* bitboard, const Shape* shape, int x, int y) {
+	int column = x + shape->min_x;
+	if (column < 0 || x + shape->max_x >= bitboard->width)
+		return true;
+	if (y + shape->min_y < 0 || y + shape->max_y >= bitboard->height)
+		return true;
+	for (int r = shape->min_y; r <= shape->max_y; r++) {
+		if (bitboard->rows[y + r] & shape->rows[r] << column)
+			return true;
+	}
+	return false;
+}
+
+bool filled(const Bitboard* bitboard, int x, int y) {
+	if (x < 0 || x >= bitboard->width || y < 0)
+		return true;
+	if (y >= bitboard->height)
+		return false;
+	return bitboard->rows[y] >> x & 1;
+}
+
+bool is_spin(const Bitboard* bitboard, int piece, int x, int y) {
+	if (piece != CITRUS_COLOR_T)
+		return false;
+	int corners = filled(bitboard, x, y) + filled(bitboard, x + 2, y)
+		+ filled(bitboard, x, y + 2) + filled(bitboard, x + 2, y + 2);
+	return corners >= 3;
+}
+
+void generator_init(Generator* generator, int width, int height, int spawn_row) {
+	generator->width = width;
+	generator->height = height;
+	generator->spawn_row = spawn_row;
+	// x, y, rotation and whether the last move was a rotation
+	generator->n_states = (width + MARGIN * 2) * (height + MARGIN * 2) * 4 * 2;
+	generator->visited = calloc(generator->n_states, sizeof(uint32_t));
+	generator->queue = malloc(sizeof(int) * generator->n_states);
+	// a piece's lowest, leftmost cell and its rotation decide its cells, and
+	// T pieces can lock with or without a spin
+	generator->max_placements = width * height * 4 * 2;
+	// keep the table of seen cells at most half full, so that it never fills
+	// up and probing stays short
+	unsigned int seen_size = 1;
+	while (seen_size < (unsigned int) generator->max_placements * 2)
+		seen_size *= 2;
+	generator->seen_mask = seen_size - 1;
+	generator->seen = malloc(sizeof(uint64_t) * seen_size);
+	generator->seen_stamps = calloc(seen_size, sizeof(uint32_t));
+	generator->stamp = 0;
+}
+
+void generator_free(Generator* generator) {
+	free(generator->visited);
+	free(generator->queue);
+	free(generator->seen);
+	free(generator->seen_stamps);
+}
+
+int encode_state(Generator* generator, int x, int y, int rotation, bool rotated) {
+	int w = generator->width + MARGIN * 2;
+	int h = generator->height + MARGIN * 2;
+	return (((rotated * 4 + rotation) * h) + y + MARGIN) * w + x + MARGIN;
+}
+
+void decode_state(Generator* generator, int state, int* x, int* y, int* rotation, bool* rotated) {
+	int w = generator->width + MARGIN * 2;
+	int h = generator->height + MARGIN * 2;
+	*x = state % w - MARGIN;
+	state /= w;
+	*y = state % h - MARGIN;
+	state /= h;
+	*rotation = state % 4;
+	*rotated = state / 4;
+}
+
+// returns false if the cells were already seen
+bool add_seen(Generator* generator, uint64_t hash) {
+	unsigned int i = hash & generator->seen_mask;
+	while (generator->seen_stamps[i] == generator->stamp) {
+		if (generator->seen[i] == hash)
+			return false;
+		i = (i + 1) & generator->seen_mask;
+	}
+	generator->seen_stamps[i] = generator->stamp;
+	generator->seen[i] = hash;
+	return true;
+}
+
+// Lists every distinct place where the piece can lock, starting from its
+// spawn position, into placements, which needs room for max_placements, or
+// only counts them if it is NULL. Returns the number of placements, or 0 if
+// the piece can't spawn.
+int generate_placements(Generator* generator, const Bitboard* bitboard, int piece, Placement* placements) {
+	int n_placements = 0;
+	int head = 0, tail = 0;
+	generator->stamp++;
+	if (generator->stamp == 0) {
+		memset(generator->visited, 0, sizeof(uint32_t) * generator->n_states);
+		memset(generator->seen_stamps, 0, sizeof(uint32_t) * (generator->seen_mask + 1));
+		generator->stamp = 1;
+	}
+	const Shape* spawn_shape = &shapes[piece][0];
+	int spawn_x = (bitboard->width - box_sizes[piece]) / 2;
+	int spawn_y = generator->spawn_row - spawn_shape->min_y;
+	if (collides(bitboard, spawn_shape, spawn_x, spawn_y))
+		return 0;
+	int start = encode_state(generator, spawn_x, spawn_y, 0, false);
+	generator->visited[start] = generator->stamp;
+	generator->queue[tail++] = start;
+	while (head < tail) {
+		int x, y, rotation;
+		bool rotated;
+		decode_state(generator, generator->queue[head++], &x, &y, &rotation, &rotated);
+		const Shape* shape = &shapes[piece][rotation];
+		if (collides(bitboard, shape, x, y - 1)) {
+			bool spin = rotated && is_spin(bitboard, piece, x, y);
+			uint64_t hash = spin ? zobrist_spin : 0;
+			for (int i = 0; i < shape->n_cells; i++)
+				hash ^= zobrist[y + shape->y[i]][x + shape->x[i]];
+			if (add_seen(generator, hash)) {
+				if (placements != NULL)
+					placements[n_placements] = (Placement) {piece, x, y, rotation, spin};
+				n_placements++;
+			}
+		}
+		// moves are tried in the order left, right, soft drop,
+		// clockwise, anticlockwise and 180
+		for (int move = 0; move < 6; move++) {
+			int new_x = x, new_y = y, new_rotation = rotation;
+			bool found = true;
+			if (move == 0) {
+				new_x--;
+			} else if (move == 1) {
+				new_x++;
+			} else if (move == 2) {
+				new_y--;
+			} else if (move == 5) {
+				new_rotation = (rotation + 2) % 4;
+			} else {
+				int direction = move - 3;
+				new_rotation = (rotation + (direction == 0 ? 1 : 3)) % 4;
+				found = false;
+				for (int k = 0; k < 5; k++) {
+					int dx, dy;
+					if (piece == CITRUS_COLOR_O) {
+						if (k > 0)
+							break;
+						dx = dy = 0;
+					} else if (piece == CITRUS_COLOR_I) {
+						dx = i_kicks[rotation][direction][k][0];
+						dy = i_kicks[rotation][direction][k][1];
+					} else {
+						dx = jlstz_kicks[rotation][direction][k][0];
+						dy = jlstz_kicks[rotation][direction][k][1];
+					}
+					if (!collides(bitboard, &shapes[piece][new_rotation], x + dx, y + dy)) {
+						new_x = x + dx;
+						new_y = y + dy;
+						found = true;
+						break;
+					}
+				}
+			}
+			if (!found || collides(bitboard, &shapes[piece][new_rotation], new_x, new_y))
+				continue;
+			int state = encode_state(generator, new_x, new_y, new_rotation, move >= 3);
+			if (generator->visited[state] != generator->stamp) {
+				generator->visited[state] = generator->stamp;
+				generator->queue[tail++] = state;
+			}
+		}
+	}
+	return n_placements;
+}
+
+// Lists the placements that only need a rotation at the spawn position,
+// shifts and a hard drop, which is all that a bot pressing keys between two
+// ticks can do. Returns the number of placements.
+int drop_placements(const Bitboard* bitboard, int piece, int spawn_row, Placement* placements) {
+	int n_placements = 0;
+	int spawn_x = (bitboard->width - box_sizes[piece]) / 2;
+	int spawn_y = spawn_row - shapes[piece][0].min_y;
+	if (collides(bitboard, &shapes[piece][0], spawn_x, spawn_y))
+		return 0;
+	for (int rotation = 0; rotation < 4; rotation++) {
+		const Shape* shape = &shapes[piece][rotation];
+		if (collides(bitboard, shape, spawn_x, spawn_y))
+			continue;
+		int left = spawn_x, right = spawn_x;
+		while (!collides(bitboard, shape, left - 1, spawn_y))
+			left--;
+		while (!collides(bitboard, shape, right + 1, spawn_y))
+			right++;
+		for (int x = left; x <= right; x++) {
+			int y = spawn_y;
+			while (!collides(bitboard, shape, x, y - 1))
+				y--;
+			placements[n_placements++] = (Placement) {piece, x, y, rotation, false};
+		}
+	}
+	return n_placements;
+}
+
+// how many columns a placement from drop_placements is shifted by, negative
+// being to the left
+int placement_shift(const Placement* placement, int width) {
+	return placement->x - (width - box_sizes[placement->piece]) / 2;
+}
+
+// Locks a piece into the board. Returns the number of lines cleared.
+int place_piece(Bitboard* bitboard, const Placement* placement) {
+	const Shape* shape = &shapes[placement->piece][placement->rotation];
+	for (int i = 0; i < shape->n_cells; i++)
+		bitboard->rows[placement->y + shape->y[i]] |= (uint64_t) 1 << (placement->x + shape->x[i]);
+	uint64_t full = bitboard->width == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << bitboard->width) - 1;
+	int cleared = 0;
+	for (int y = 0; y < bitboard->height; y++) {
+		if (bitboard->rows[y] == full)
+			cleared++;
+		else if (cleared > 0)
+			bitboard->rows[y - cleared] = bitboard->rows[y];
+	}
+	for (int y = bitboard->height - cleared; y < bitboard->height; y++)
+		bitboard->rows[y] = 0;
+	return cleared;
+}
+
+// placements has room for max_placements for each piece but the last, which
+// is only counted
+uint64_t perft_from(Generator* generator, const Bitboard* bitboard, const int* queue, int depth, Placement* placements) {
+	if (depth == 1)
+		return generate_placements(generator, bitboard, queue[0], NULL);
+	int n = generate_placements(generator, bitboard, queue[0], placements);
+	uint64_t nodes = 0;
+	for (int i = 0; i < n; i++) {
+		Bitboard child = *bitboard;
+		place_piece(&child, &placements[i]);
+		nodes += perft_from(generator, &child, queue + 1, depth - 1, placements + generator->max_placements);
+	}
+	return nodes;
+}
+
+// Counts the sequences of placements of the pieces in queue, depth pieces
+// deep.
+uint64_t perft(Generator* generator, const Bitboard* bitboard, const int* queue, int depth) {
+	if (depth == 0)
+		return 1;
+	Placement* placements = malloc(sizeof(Placement) * generator->max_placements * (depth - 1));
+	uint64_t nodes = perft_from(generator, bitboard, queue, depth, placements);
+	free(placements);
+	return nodes;
+}
@@ -0,0 +1,189 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include "bot.h"
+#include "game.h"
+
+// Scores boards with Pierre Dellacherie's features: where the piece landed,
+// lines cleared, how often cells change between filled and empty along rows
+// and columns, holes and wells. The weights are the ones found for
+// El-Tetris.
+
+#define LANDING_WEIGHT (-4.500158825082766)
+#define LINES_WEIGHT 3.4181268101392694
+#define ROW_TRANSITIONS_WEIGHT (-3.2178882868487753)
+#define COLUMN_TRANSITIONS_WEIGHT (-9.348695305445199)
+#define HOLES_WEIGHT (-7.899265427351652)
+#define WELLS_WEIGHT (-3.3855972247263626)
+
+double evaluate_board(const Bitboard* bitboard, int landing_height, int lines) {
+	int width = bitboard->width;
+	uint64_t full = width == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << width) - 1;
+	int row_transitions = 0;
+	int column_transitions = 0;
+	int holes = 0;
+	int wells = 0;
+	// the floor counts as filled
+	uint64_t below = full;
+	int top = 0;
+	for (; top < bitboard->height; top++) {
+		uint64_t row = bitboard->rows[top];
+		if (row == 0 && below == 0)
+			break;
+		// and so do the walls
+		uint64_t walled = row << 1 | 1 | (uint64_t) 1 << (width + 1);
+		row_transitions += __builtin_popcountll((walled ^ walled >> 1) & (full << 1 | 1));
+		column_transitions += __builtin_popcountll(row ^ below);
+		below = row;
+	}
+	column_transitions += __builtin_popcountll(below);
+	uint64_t covered = 0;
+	uint64_t wells_above = 0;
+	int well_depth[BITBOARD_MAX_WIDTH];
+	for (int y = top - 1; y >= 0; y--) {
+		uint64_t row = bitboard->rows[y];
+		holes += __builtin_popcountll(covered & ~row);
+		covered |= row;
+		uint64_t well = ~row & (row << 1 | 1) & (row >> 1 | (uint64_t) 1 << (width - 1)) & full;
+		// wells get deeper the further down they go
+		for (uint64_t bits = well & ~wells_above; bits != 0; bits &= bits - 1)
+			well_depth[__builtin_ctzll(bits)] = 0;
+		for (uint64_t bits = well; bits != 0; bits &= bits - 1)
+			wells += ++well_depth[__builtin_ctzll(bits)];
+		wells_above = well;
+	}
+	return landing_height * LANDING_WEIGHT + lines * LINES_WEIGHT
+		+ row_transitions * ROW_TRANSITIONS_WEIGHT + column_transitions * COLUMN_TRANSITIONS_WEIGHT
+		+ holes * HOLES_WEIGHT + wells * WELLS_WEIGHT;
+}
+
+// Picks the best place for a piece out of the ones reached by a rotation,
+// shifts and a hard drop. Returns false if the piece can't spawn.
+bool bot_best_drop(const Bitboard* bitboard, int piece, int spawn_row, Placement* best) {
+	Placement placements[MAX_PLACEMENTS];
+	int n = drop_placements(bitboard, piece, spawn_row, placements);
+	double best_score = 0;
+	for (int i = 0; i < n; i++) {
+		Bitboard child = *bitboard;
+		int lines = place_piece(&child, &placements[i]);
+		double score = evaluate_board(&child, placements[i].y, lines);
+		if (i == 0 || score > best_score) {
+			best_score = score;
+			*best = placements[i];
+		}
+	}
+	return n > 0;
+}
+
+void bot_search_init(BotSearch* search, int max_width) {
+	search->max_width = max_width;
+	search->beam = malloc(sizeof(BeamNode) * max_width);
+	search->next_beam = malloc(sizeof(BeamNode) * max_width);
+	search->candidates = malloc(sizeof(BeamCandidate) * max_width * 4 * BITBOARD_MAX_WIDTH);
+	search->placements = malloc(sizeof(Placement) * max_width * 4 * BITBOARD_MAX_WIDTH);
+}
+
+void bot_search_free(BotSearch* search) {
+	free(search->beam);
+	free(search->next_beam);
+	free(search->candidates);
+	free(search->placements);
+}
+
+int compare_candidates(const void* a, const void* b) {
+	double score_a = ((const BeamCandidate*) a)->score;
+	double score_b = ((const BeamCandidate*) b)->score;
+	return score_a < score_b ? 1 : score_a > score_b ? -1 : 0;
+}
+
+// One beam search through all the pieces, keeping the width best boards
+// after each one, where a board's score is the sum of the scores of the
+// boards on the way to it. Gives the first move towards the best board at
+// the end, or -1 if time ran out.
+int beam_search(BotSearch* search, const Bitboard* bitboard, const int* pieces, int n_pieces, int spawn_row,
+	int width, double deadline, BotSearchStats* stats) {
+	search->beam[0].board = *bitboard;
+	search->beam[0].score = 0;
+	search->beam[0].first = -1;
+	int beam_size = 1;
+	for (int depth = 0; depth < n_pieces; depth++) {
+		int n_candidates = 0;
+		for (int i = 0; i < beam_size; i++) {
+			const BeamNode* node = &search->beam[i];
+			Placement* placements = search->placements + n_candidates;
+			int n = drop_placements(&node->board, pieces[depth], spawn_row, placements);
+			for (int j = 0; j < n; j++) {
+				Bitboard child = node->board;
+				int lines = place_piece(&child, &placements[j]);
+				BeamCandidate* candidate = &search->candidates[n_candidates + j];
+				candidate->parent = i;
+				candidate->placement = n_candidates + j;
+				candidate->score = node->score + evaluate_board(&child, placements[j].y, lines);
+			}
+			n_candidates += n;
+			stats->nodes += n;
+			if (now() >= deadline)
+				return -1;
+		}
+		if (n_candidates == 0)
+			break;
+		qsort(search->candidates, n_candidates, sizeof(BeamCandidate), compare_candidates);
+		beam_size = n_candidates < width ? n_candidates : width;
+		for (int i = 0; i < beam_size; i++) {
+			const BeamCandidate* candidate = &search->candidates[i];
+			const BeamNode* parent = &search->beam[candidate->parent];
+			BeamNode* node = &search->next_beam[i];
+			node->board = parent->board;
+			place_piece(&node->board, &search->placements[candidate->placement]);
+			node->score = candidate->score;
+			node->first = depth == 0 ? candidate->placement : parent->first;
+		}
+		BeamNode* swap = search->beam;
+		search->beam = search->next_beam;
+		search->next_beam = swap;
+	}
+	return search->beam[0].first;
+}
+
+// Searches for the best place for pieces[0], looking ahead at the rest,
+// until the deadline. This is an anytime search: the best single drop is
+// found first, then beam searches through all the pieces with wider and
+// wider beams, and the last one to finish in time gives the answer.
+// Returns false if the piece can't spawn.
+bool bot_search(BotSearch* search, const Bitboard* bitboard, const int* pieces, int n_pieces, int spawn_row,
+	double deadline, Placement* best, BotSearchStats* stats) {
+	stats->nodes = 0;
+	stats->width = 0;
+	stats->depth = 1;
+	if (!bot_best_drop(bitboard, pieces[0], spawn_row, best))
+		return false;
+	// the first pieces' placements, which beam_search gives the index of
+	Placement first_placements[MAX_PLACEMENTS];
+	drop_placements(bitboard, pieces[0], spawn_row, first_placements);
+	for (int width = 4; width <= search->max_width && n_pieces > 1; width *= 2) {
+		int first = beam_search(search, bitboard, pieces, n_pieces, spawn_row, width, deadline, stats);
+		if (first < 0)
+			break;
+		*best = first_placements[first];
+		stats->width = width;
+		stats->depth = n_pieces;
+	}
+	return true;
+}
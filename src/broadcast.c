@@ -0,0 +1,414 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "broadcast.h"
+#include "net.h"
+
+// Sends a game to any number of spectators, using the same messages as the
+// server. Each frame is encoded once, as the changes since the last frame,
+// and every viewer sends straight from the same copy of it. Every so often
+// a keyframe has the whole board, and viewers that fall behind throw away
+// what they haven't started sending and wait for the next one.
+//
+// The game thread encodes the frames, and a thread of its own does all the
+// sending, so that slow viewers can't hold up the game.
+
+#define MAX_EVENTS 256
+#define MAX_QUEUED 64
+#define PENDING_SIZE 64
+#define KEYFRAME_INTERVAL 120
+#define MIN_KEYFRAME_GAP 10
+#define STOP_TIMEOUT 1.0
+
+typedef struct {
+	atomic_int refs;
+	bool keyframe;
+	size_t size;
+	unsigned char data[];
+} Frame;
+
+typedef struct Viewer Viewer;
+
+struct Viewer {
+	int fd;
+	Frame* queue[MAX_QUEUED];
+	int head;
+	int count;
+	size_t offset;
+	bool waiting;
+	bool writing;
+	bool removed;
+	Viewer* next;
+};
+
+bool broadcasting = false;
+pthread_t broadcast_thread;
+int broadcast_listen_fd;
+int broadcast_epoll_fd;
+int broadcast_event_fd;
+atomic_bool keyframe_wanted;
+atomic_bool stopping;
+Frame* config_frame;
+Viewer* viewers = NULL;
+
+// frames waiting to be picked up by the broadcast thread
+pthread_mutex_t pending_lock = PTHREAD_MUTEX_INITIALIZER;
+Frame* pending[PENDING_SIZE];
+int pending_head = 0;
+int pending_count = 0;
+
+// what the viewers have been sent, only used by the game thread
+int* broadcast_board;
+Buffer broadcast_state;
+int frames_since_keyframe = KEYFRAME_INTERVAL;
+
+Frame* frame_new(const Buffer* buffer, bool keyframe) {
+	Frame* frame = malloc(sizeof(Frame) + buffer->size);
+	atomic_init(&frame->refs, 1);
+	frame->keyframe = keyframe;
+	frame->size = buffer->size;
+	memcpy(frame->data, buffer->data, buffer->size);
+	return frame;
+}
+
+void frame_release(Frame* frame) {
+	if (atomic_fetch_sub(&frame->refs, 1) == 1)
+		free(frame);
+}
+
+void push_frame(Frame* frame) {
+	pthread_mutex_lock(&pending_lock);
+	if (pending_count == PENDING_SIZE) {
+		// the broadcast thread is stuck, so everyone will need a keyframe
+		frame_release(frame);
+		atomic_store(&keyframe_wanted, true);
+	} else {
+		pending[(pending_head + pending_count) % PENDING_SIZE] = frame;
+		pending_count++;
+	}
+	pthread_mutex_unlock(&pending_lock);
+	uint64_t one = 1;
+	if (write(broadcast_event_fd, &one, sizeof(one)) < 0)
+		perror("broadcast");
+}
+
+void remove_viewer(Viewer* viewer) {
+	if (viewer->removed)
+		return;
+	epoll_ctl(broadcast_epoll_fd, EPOLL_CTL_DEL, viewer->fd, NULL);
+	close(viewer->fd);
+	viewer->removed = true;
+}
+
+void free_removed_viewers(void) {
+	Viewer** p = &viewers;
+	while (*p != NULL) {
+		Viewer* viewer = *p;
+		if (!viewer->removed) {
+			p = &viewer->next;
+			continue;
+		}
+		*p = viewer->next;
+		for (int i = 0; i < viewer->count; i++)
+			frame_release(viewer->queue[(viewer->head + i) % MAX_QUEUED]);
+		free(viewer);
+	}
+}
+
+void queue_frame(Viewer* viewer, Frame* frame) {
+	if (viewer->waiting && !frame->keyframe)
+		return;
+	if (viewer->count == MAX_QUEUED) {
+		// too slow to keep up, so drop everything that hasn't started
+		// going out yet
+		int keep = viewer->offset > 0 || viewer->queue[viewer->head] == config_frame ? 1 : 0;
+		for (int i = keep; i < viewer->count; i++)
+			frame_release(viewer->queue[(viewer->head + i) % MAX_QUEUED]);
+		viewer->count = keep;
+		viewer->waiting = true;
+		atomic_store(&keyframe_wanted, true);
+		if (!frame->keyframe)
+			return;
+	}
+	viewer->waiting = false;
+	atomic_fetch_add(&frame->refs, 1);
+	viewer->queue[(viewer->head + viewer->count) % MAX_QUEUED] = frame;
+	viewer->count++;
+}
+
+void flush_viewer(Viewer* viewer) {
+	while (viewer->count > 0) {
+		struct iovec iov[MAX_QUEUED];
+		for (int i = 0; i < viewer->count; i++) {
+			Frame* frame = viewer->queue[(viewer->head + i) % MAX_QUEUED];
+			size_t offset = i == 0 ? viewer->offset : 0;
+			iov[i].iov_base = frame->data + offset;
+			iov[i].iov_len = frame->size - offset;
+		}
+		struct msghdr message = {.msg_iov = iov, .msg_iovlen = viewer->count};
+		ssize_t n = sendmsg(viewer->fd, &message, MSG_NOSIGNAL);
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if (n <= 0) {
+			remove_viewer(viewer);
+			return;
+		}
+		while (n > 0) {
+			Frame* frame = viewer->queue[viewer->head];
+			size_t left = frame->size - viewer->offset;
+			if ((size_t) n < left) {
+				viewer->offset += n;
+				break;
+			}
+			n -= left;
+			frame_release(frame);
+			viewer->head = (viewer->head + 1) % MAX_QUEUED;
+			viewer->count--;
+			viewer->offset = 0;
+		}
+	}
+	bool writing = viewer->count > 0;
+	if (writing != viewer->writing) {
+		struct epoll_event event = {.events = EPOLLIN | (writing ? EPOLLOUT : 0), .data.ptr = viewer};
+		epoll_ctl(broadcast_epoll_fd, EPOLL_CTL_MOD, viewer->fd, &event);
+		viewer->writing = writing;
+	}
+}
+
+void accept_viewers(void) {
+	while (true) {
+		int fd = accept(broadcast_listen_fd, NULL, NULL);
+		if (fd < 0)
+			return;
+		set_nonblocking(fd);
+		Viewer* viewer = calloc(1, sizeof(Viewer));
+		viewer->fd = fd;
+		struct epoll_event event = {.events = EPOLLIN, .data.ptr = viewer};
+		epoll_ctl(broadcast_epoll_fd, EPOLL_CTL_ADD, fd, &event);
+		viewer->next = viewers;
+		viewers = viewer;
+		atomic_fetch_add(&config_frame->refs, 1);
+		viewer->queue[0] = config_frame;
+		viewer->count = 1;
+		viewer->waiting = true;
+		atomic_store(&keyframe_wanted, true);
+		flush_viewer(viewer);
+	}
+}
+
+void send_pending_frames(void) {
+	uint64_t count;
+	if (read(broadcast_event_fd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+		perror("broadcast");
+	Frame* frames[PENDING_SIZE];
+	int n = 0;
+	pthread_mutex_lock(&pending_lock);
+	while (pending_count > 0) {
+		frames[n++] = pending[pending_head];
+		pending_head = (pending_head + 1) % PENDING_SIZE;
+		pending_count--;
+	}
+	pthread_mutex_unlock(&pending_lock);
+	for (int i = 0; i < n; i++) {
+		for (Viewer* viewer = viewers; viewer != NULL; viewer = viewer->next) {
+			if (!viewer->removed)
+				queue_frame(viewer, frames[i]);
+		}
+		frame_release(frames[i]);
+	}
+	for (Viewer* viewer = viewers; viewer != NULL; viewer = viewer->next) {
+		if (!viewer->removed && viewer->count > 0)
+			flush_viewer(viewer);
+	}
+}
+
+bool viewers_flushed(void) {
+	for (Viewer* viewer = viewers; viewer != NULL; viewer = viewer->next) {
+		if (!viewer->removed && viewer->count > 0)
+			return false;
+	}
+	return true;
+}
+
+void* broadcast_main(void* data) {
+	(void) data;
+	double deadline = 0;
+	while (true) {
+		bool stop = atomic_load(&stopping);
+		if (stop && deadline == 0) {
+			deadline = now() + STOP_TIMEOUT;
+			send_pending_frames();
+		}
+		if (stop && (viewers_flushed() || now() >= deadline))
+			break;
+		struct epoll_event events[MAX_EVENTS];
+		int n = epoll_wait(broadcast_epoll_fd, events, MAX_EVENTS, stop ? 100 : -1);
+		if (n < 0 && errno != EINTR) {
+			perror("epoll_wait");
+			break;
+		}
+		for (int i = 0; i < n; i++) {
+			void* ptr = events[i].data.ptr;
+			if (ptr == &broadcast_listen_fd) {
+				accept_viewers();
+			} else if (ptr == &broadcast_event_fd) {
+				send_pending_frames();
+			} else {
+				Viewer* viewer = ptr;
+				if (!viewer->removed && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+					// viewers have nothing to say, so this is them
+					// going away
+					char buffer[256];
+					ssize_t size = recv(viewer->fd, buffer, sizeof(buffer), 0);
+					if (size == 0 || (size < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+						remove_viewer(viewer);
+				}
+				if (!viewer->removed && (events[i].events & EPOLLOUT))
+					flush_viewer(viewer);
+			}
+		}
+		free_removed_viewers();
+	}
+	for (Viewer* viewer = viewers; viewer != NULL; viewer = viewer->next)
+		remove_viewer(viewer);
+	free_removed_viewers();
+	return NULL;
+}
+
+// Starts letting spectators watch the game. The config has to be set up
+// already.
+bool broadcast_start(const char* address) {
+	broadcast_listen_fd = net_listen(address);
+	if (broadcast_listen_fd < 0)
+		return false;
+	set_nonblocking(broadcast_listen_fd);
+	broadcast_epoll_fd = epoll_create1(0);
+	broadcast_event_fd = eventfd(0, EFD_NONBLOCK);
+	struct epoll_event event = {.events = EPOLLIN, .data.ptr = &broadcast_listen_fd};
+	epoll_ctl(broadcast_epoll_fd, EPOLL_CTL_ADD, broadcast_listen_fd, &event);
+	event.data.ptr = &broadcast_event_fd;
+	epoll_ctl(broadcast_epoll_fd, EPOLL_CTL_ADD, broadcast_event_fd, &event);
+	Buffer buffer = {0};
+	size_t start = message_begin(&buffer, MSG_CONFIG);
+	put_varint(&buffer, config.width);
+	put_varint(&buffer, config.full_height);
+	put_varint(&buffer, config.next_piece_queue_size);
+	put_varint(&buffer, 0);
+	message_end(&buffer, start);
+	config_frame = frame_new(&buffer, false);
+	buffer_free(&buffer);
+	broadcast_board = malloc(sizeof(int) * config.full_height * config.width);
+	atomic_init(&keyframe_wanted, false);
+	atomic_init(&stopping, false);
+	pthread_create(&broadcast_thread, NULL, broadcast_main, NULL);
+	broadcasting = true;
+	return true;
+}
+
+int broadcast_piece_id(const CitrusPiece* piece) {
+	return piece == NULL ? NO_PIECE : piece_id(piece);
+}
+
+// Encodes the changes since the last frame for every viewer.
+void broadcast_frame(const View* view) {
+	if (!broadcasting)
+		return;
+	bool keyframe = frames_since_keyframe >= KEYFRAME_INTERVAL
+		|| (frames_since_keyframe >= MIN_KEYFRAME_GAP && atomic_load(&keyframe_wanted));
+	Buffer buffer = {0};
+	size_t start = 0;
+	int skip = 0;
+	for (int i = 0; i < config.full_height * config.width; i++) {
+		int color = cell_color(view->board[i]);
+		if (!keyframe && color == broadcast_board[i]) {
+			skip++;
+			continue;
+		}
+		if (start == 0)
+			start = message_begin(&buffer, MSG_BOARD);
+		put_varint(&buffer, skip);
+		put_byte(&buffer, color);
+		broadcast_board[i] = color;
+		skip = 0;
+	}
+	if (start != 0)
+		message_end(&buffer, start);
+	Buffer state = {0};
+	put_byte(&state, broadcast_piece_id(view->hold_piece));
+	for (int i = 0; i < config.next_piece_queue_size; i++)
+		put_byte(&state, broadcast_piece_id(view->next_pieces[i]));
+	put_varint(&state, view->score);
+	put_varint(&state, view->level);
+	put_varint(&state, view->lines);
+	put_varint(&state, view->pieces);
+	if (keyframe || state.size != broadcast_state.size || memcmp(state.data, broadcast_state.data, state.size) != 0) {
+		start = message_begin(&buffer, MSG_STATE);
+		buffer_append(&buffer, state.data, state.size);
+		put_varint(&buffer, view->ticks);
+		message_end(&buffer, start);
+		buffer_free(&broadcast_state);
+		broadcast_state = state;
+	} else {
+		buffer_free(&state);
+	}
+	if (buffer.size > 0)
+		push_frame(frame_new(&buffer, keyframe));
+	buffer_free(&buffer);
+	if (keyframe) {
+		frames_since_keyframe = 0;
+		atomic_store(&keyframe_wanted, false);
+	} else {
+		frames_since_keyframe++;
+	}
+}
+
+// Tells the spectators that the game is over, and gives them a moment to
+// get the last frames.
+void broadcast_stop(void) {
+	if (!broadcasting)
+		return;
+	Buffer buffer = {0};
+	size_t start = message_begin(&buffer, MSG_GAME_OVER);
+	message_end(&buffer, start);
+	// everyone gets this, even viewers waiting for a keyframe
+	push_frame(frame_new(&buffer, true));
+	buffer_free(&buffer);
+	atomic_store(&stopping, true);
+	uint64_t one = 1;
+	if (write(broadcast_event_fd, &one, sizeof(one)) < 0)
+		perror("broadcast");
+	pthread_join(broadcast_thread, NULL);
+	close(broadcast_listen_fd);
+	close(broadcast_epoll_fd);
+	close(broadcast_event_fd);
+	frame_release(config_frame);
+	free(broadcast_board);
+	buffer_free(&broadcast_state);
+	broadcasting = false;
+}
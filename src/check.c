@@ -0,0 +1,225 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "finesse.h"
+#include "game.h"
+#include "replay.h"
+#include "snapshot.h"
+
+// Checks that sleeping through idle ticks doesn't change how a game plays
+// out. Each game is recorded into a replay with made up key presses, then
+// played back twice: once as it is, and once running the game ahead
+// between every two ticks, the way the main loop does before it sleeps.
+// The two playbacks have to match on every tick, including the lines sent,
+// and both have to end the way the replay says.
+//
+// It also checks that every one key finesse move puts its piece where the
+// table says, for each preset on its own board and on narrow and wide ones.
+
+#define MAX_TICKS 20000
+
+const char* program_name;
+unsigned int seed = 1;
+int n_games = 200;
+uint32_t rng_state;
+
+uint32_t check_random(void) {
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+bool record_key(CitrusKey key, bool up) {
+	replay_record_key(key, up);
+	return false;
+}
+
+void press(CitrusKey key) {
+	game_key_down(key);
+	game_key_up(key);
+}
+
+// everything about the game that can be seen or is scored
+uint64_t state_hash(void) {
+	int values[] = {game.score, game.lines, game.level, pieces, ticks, attack, CitrusGame_is_alive(&game),
+		game.hold_piece == NULL ? -1 : piece_id(game.hold_piece)};
+	uint64_t hash = 14695981039346656037u;
+	const unsigned char* bytes = (const unsigned char*) values;
+	for (size_t i = 0; i < sizeof(values); i++)
+		hash = (hash ^ bytes[i]) * 1099511628211u;
+	for (int i = 0; i < config.width * config.full_height; i++)
+		hash = (hash ^ (board[i].type * 16 + board[i].color)) * 1099511628211u;
+	return hash;
+}
+
+void record(const char* path, unsigned int game_seed) {
+	init_citrus(game_seed);
+	if (!replay_record_start(path, 0, game_seed)) {
+		perror(path);
+		exit(-1);
+	}
+	while (CitrusGame_is_alive(&game) && ticks < MAX_TICKS) {
+		uint32_t r = check_random();
+		if (r % 16 == 0) {
+			// a piece dropped somewhere random, which fills narrow
+			// boards evenly enough to clear lines
+			for (uint32_t i = (r >> 4) % 4; i > 0; i--)
+				press(CITRUS_KEY_CLOCKWISE);
+			int shift = (int) ((r >> 6) % 9) - 4;
+			for (int i = 0; i < abs(shift); i++)
+				press(shift < 0 ? CITRUS_KEY_LEFT : CITRUS_KEY_RIGHT);
+			press((r >> 10) % 8 == 0 ? CITRUS_KEY_HOLD : CITRUS_KEY_HARD_DROP);
+		} else if (r % 16 == 1) {
+			// soft drop is held for a while
+			if ((r >> 4) % 2 == 0)
+				game_key_down(CITRUS_KEY_SOFT_DROP);
+			else
+				game_key_up(CITRUS_KEY_SOFT_DROP);
+		}
+		// like the main loop, a key that tops out ends the game there
+		if (!CitrusGame_is_alive(&game))
+			break;
+		CitrusGame_tick(&game);
+		ticks++;
+	}
+	replay_record_end();
+	free_citrus();
+}
+
+// Plays the replay back, filling in the state after each tick, and returns
+// how many ticks there were.
+int play(const char* path, bool lookahead, uint64_t* hashes) {
+	unsigned int game_seed;
+	if (!replay_open(path, &game_seed)) {
+		fprintf(stderr, "%s: can't read back %s\n", program_name, path);
+		exit(-1);
+	}
+	init_citrus(game_seed);
+	if (lookahead && !lookahead_start()) {
+		fprintf(stderr, "%s: out of memory\n", program_name);
+		exit(-1);
+	}
+	int n = 0;
+	while (CitrusGame_is_alive(&game) && !replay_finished() && n < MAX_TICKS) {
+		if (lookahead)
+			ticks_until_change(tick_rate);
+		replay_apply();
+		if (!CitrusGame_is_alive(&game))
+			break;
+		CitrusGame_tick(&game);
+		ticks++;
+		hashes[n++] = state_hash();
+	}
+	if (!replay_verify()) {
+		fprintf(stderr, "%s: playback %s lookahead doesn't match the replay\n", program_name, lookahead ? "with" : "without");
+		exit(1);
+	}
+	if (lookahead)
+		lookahead_stop();
+	replay_close();
+	free_citrus();
+	return n;
+}
+
+int main(int argc, char** argv) {
+	program_name = argv[0];
+	int c;
+	while ((c = getopt(argc, argv, "n:s:")) != -1) {
+		switch (c) {
+			case 'n':
+				n_games = strtol(optarg, NULL, 10);
+				break;
+			case 's':
+				seed = strtoul(optarg, NULL, 10);
+				break;
+			case '?':
+				exit(-1);
+			default:
+				break;
+		}
+	}
+	init_piece_table();
+	game_hooks.send_key = record_key;
+	rng_state = seed | 1;
+	char path[] = "/tmp/txtris-check-XXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0) {
+		perror(path);
+		exit(-1);
+	}
+	close(fd);
+	uint64_t* plain = malloc(sizeof(uint64_t) * MAX_TICKS);
+	uint64_t* idle = malloc(sizeof(uint64_t) * MAX_TICKS);
+	long long total_ticks = 0, total_attack = 0;
+	int failures = 0;
+	for (int i = 0; i < n_games; i++) {
+		// narrow boards clear lines often, so that sent lines are checked
+		config = citrus_preset_modern;
+		if (i % 2 == 1)
+			config.width = 4;
+		record(path, seed + i);
+		int n_plain = play(path, false, plain);
+		int attack_plain = attack;
+		int n_idle = play(path, true, idle);
+		int tick = 0;
+		while (tick < n_plain && tick < n_idle && plain[tick] == idle[tick])
+			tick++;
+		if (n_plain != n_idle || tick < n_plain || attack != attack_plain) {
+			printf("game %i (seed %u, width %i): differs at tick %i\n", i, seed + i, config.width, tick);
+			failures++;
+		}
+		total_ticks += n_plain;
+		total_attack += attack_plain;
+	}
+	unlink(path);
+	free(plain);
+	free(idle);
+	printf("%i games, %lli ticks, %lli lines sent: %i differ with idle lookahead\n", n_games, total_ticks, total_attack, failures);
+	int widths[] = {0, 4, 24};
+	int total_moves = 0, misplaced = 0;
+	for (int i = 0; i < N_PRESETS; i++) {
+		for (size_t j = 0; j < sizeof(widths) / sizeof(widths[0]); j++) {
+			config = *presets[i].config;
+			if (widths[j] != 0)
+				config.width = widths[j];
+			if (!init_finesse()) {
+				printf("%s preset, width %i: can't work out the finesse moves\n", presets[i].name, config.width);
+				misplaced++;
+				continue;
+			}
+			int n_moves;
+			int wrong = check_finesse(&n_moves);
+			if (wrong > 0 || n_moves < N_PIECES * 4 * KEY_COLUMNS)
+				printf("%s preset, width %i: %i of %i finesse moves land elsewhere, %i keys have none\n",
+					presets[i].name, config.width, wrong, n_moves, N_PIECES * 4 * KEY_COLUMNS - n_moves);
+			total_moves += n_moves;
+			misplaced += wrong;
+			free_finesse();
+		}
+	}
+	printf("%i finesse moves: %i land elsewhere\n", total_moves, misplaced);
+	failures += misplaced;
+	return failures > 0;
+}
@@ -0,0 +1,242 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "client.h"
+#include "net.h"
+
+// When connected to a server, the game runs on the server and this keeps a
+// copy of what is needed to draw it.
+
+bool connected = false;
+bool spectating = false;
+bool game_over = false;
+int client_fd = -1;
+Buffer client_input;
+Buffer client_output;
+CitrusCell* client_board;
+const CitrusPiece* client_hold_piece;
+const CitrusPiece** client_next_pieces;
+int client_score, client_level, client_lines, client_pieces, client_ticks;
+
+const CitrusPiece* get_piece(int id) {
+	if (id == NO_PIECE)
+		return NULL;
+	if (id < 0 || id >= N_PIECES || pieces_by_id[id] == NULL)
+		return pieces_by_id[0];
+	return pieces_by_id[id];
+}
+
+void flush_client_output(void) {
+	while (client_output.size > 0) {
+		ssize_t n = send(client_fd, client_output.data, client_output.size, MSG_NOSIGNAL);
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return;
+		if (n <= 0) {
+			game_over = true;
+			client_output.size = 0;
+			return;
+		}
+		buffer_consume(&client_output, n);
+	}
+}
+
+// returns false if the connection was closed
+bool receive(void) {
+	while (true) {
+		unsigned char buffer[4096];
+		ssize_t n = recv(client_fd, buffer, sizeof(buffer), 0);
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return true;
+		if (n <= 0)
+			return false;
+		buffer_append(&client_input, buffer, n);
+		if ((size_t) n < sizeof(buffer))
+			return true;
+	}
+}
+
+void handle_server_message(Message* message) {
+	int size = config.full_height * config.width;
+	switch (message->type) {
+		case MSG_BOARD: {
+			// each cell comes after a count of the unchanged ones before
+			// it, which stops being read once it runs off the board
+			uint64_t i = 0;
+			while (message->data != message->end) {
+				uint64_t skip = get_varint(message);
+				if (skip >= (uint64_t) size - i)
+					break;
+				i += skip;
+				int color = get_byte(message);
+				if (color >= 0 && color < N_PIECES + 2)
+					client_board[i] = cells_by_color[color];
+				i++;
+			}
+			break;
+		}
+		case MSG_STATE:
+			client_hold_piece = get_piece(get_byte(message));
+			for (int i = 0; i < config.next_piece_queue_size; i++)
+				client_next_pieces[i] = get_piece(get_byte(message));
+			client_score = get_varint(message);
+			client_level = get_varint(message);
+			client_lines = get_varint(message);
+			client_pieces = get_varint(message);
+			client_ticks = get_varint(message);
+			break;
+		case MSG_ATTACK: {
+			int player = get_varint(message);
+			int lines = get_varint(message);
+			set_action_text("Player %i sent %i lines", player + 1, lines);
+			break;
+		}
+		case MSG_GAME_OVER:
+			game_over = true;
+			break;
+	}
+}
+
+// waits for the game to be set up, and sets up the config to match it
+bool wait_for_config(void) {
+	while (true) {
+		size_t offset = 0;
+		Message message;
+		if (next_message(&client_input, &offset, &message)) {
+			if (message.type != MSG_CONFIG)
+				break;
+			uint64_t width = get_varint(&message);
+			uint64_t full_height = get_varint(&message);
+			uint64_t queue_size = get_varint(&message);
+			buffer_consume(&client_input, offset);
+			// these size the allocations below
+			if (width > MAX_BOARD_CELLS || full_height > MAX_BOARD_CELLS || queue_size > MAX_QUEUE_SIZE
+				|| !valid_board_size(width, full_height, queue_size))
+				return false;
+			config.width = width;
+			config.full_height = full_height;
+			config.next_piece_queue_size = queue_size;
+			int size = config.full_height * config.width;
+			client_board = malloc(sizeof(CitrusCell) * size);
+			for (int i = 0; i < size; i++)
+				client_board[i] = cells_by_color[0];
+			client_next_pieces = malloc(sizeof(CitrusPiece*) * config.next_piece_queue_size);
+			for (int i = 0; i < config.next_piece_queue_size; i++)
+				client_next_pieces[i] = get_piece(0);
+			set_nonblocking(client_fd);
+			connected = true;
+			return true;
+		}
+		unsigned char buffer[4096];
+		ssize_t n = recv(client_fd, buffer, sizeof(buffer), 0);
+		if (n <= 0)
+			break;
+		buffer_append(&client_input, buffer, n);
+	}
+	// the room was full, or the server went away
+	close(client_fd);
+	return false;
+}
+
+// Connects to a server and waits to be put in a game. This sets up the
+// config, so it has to be called before the windows are set up.
+bool client_connect(const char* address, int room) {
+	init_piece_table();
+	client_fd = net_connect(address);
+	if (client_fd < 0)
+		return false;
+	size_t start = message_begin(&client_output, MSG_JOIN);
+	put_varint(&client_output, room);
+	message_end(&client_output, start);
+	flush_client_output();
+	return wait_for_config();
+}
+
+// Watches a game being broadcast. Key presses are ignored.
+bool client_watch(const char* address) {
+	init_piece_table();
+	client_fd = net_connect(address);
+	if (client_fd < 0)
+		return false;
+	spectating = true;
+	return wait_for_config();
+}
+
+void client_disconnect(void) {
+	if (!connected)
+		return;
+	close(client_fd);
+	free(client_board);
+	free(client_next_pieces);
+	buffer_free(&client_input);
+	buffer_free(&client_output);
+	connected = false;
+}
+
+bool client_connected(void) {
+	return connected;
+}
+
+bool client_alive(void) {
+	return !game_over;
+}
+
+// Handles everything the server has sent. Returns true if anything changed.
+bool client_poll(void) {
+	if (!receive())
+		game_over = true;
+	size_t offset = 0;
+	Message message;
+	bool changed = false;
+	while (next_message(&client_input, &offset, &message)) {
+		handle_server_message(&message);
+		changed = true;
+	}
+	buffer_consume(&client_input, offset);
+	flush_client_output();
+	return changed;
+}
+
+void client_send_key(CitrusKey key, bool up) {
+	if (spectating)
+		return;
+	size_t start = message_begin(&client_output, MSG_KEY);
+	put_byte(&client_output, key | (up ? 0x80 : 0));
+	message_end(&client_output, start);
+	flush_client_output();
+}
+
+void client_get_view(View* view) {
+	view->board = client_board;
+	view->hold_piece = client_hold_piece;
+	view->next_pieces = client_next_pieces;
+	view->score = client_score;
+	view->level = client_level;
+	view->lines = client_lines;
+	view->pieces = client_pieces;
+	view->ticks = client_ticks;
+	view->attack = 0;
+	view->action_text = action_text;
+	view->action_text_count = action_text_count;
+	view->opponent = NULL;
+}
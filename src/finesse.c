@@ -0,0 +1,482 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "finesse.h"
+
+// libcitrus doesn't say where pieces spawn or how they turn and kick, so
+// the finesse moves are found by playing them. Each piece is dropped into a
+// scratch game that only deals that piece, and the positions it can reach
+// are searched breadth first from the spawn, one tap, turn or slide to the
+// wall at a time, until every key has a move.
+//
+// The falling piece and its shadow are the only cells on the scratch
+// board, so a position is saved as the game and those few cells, and
+// loading it puts them back instead of copying the whole board.
+
+// enough for a piece, its shadow and a locked piece
+#define MAX_STATE_CELLS 16
+// different shapes that a piece can have after turning
+#define MAX_SHAPES 8
+
+typedef struct {
+	// the full cells as bits of a 4x4 box, bit y * 4 + x
+	int shape;
+	// the bottom left corner of the box
+	int x;
+	int y;
+} Position;
+
+typedef struct {
+	CitrusGame game;
+	int n_cells;
+	int cell_index[MAX_STATE_CELLS];
+	CitrusCell cells[MAX_STATE_CELLS];
+	Position position;
+	// the state this one was reached from, and the key that did it
+	int parent;
+	FinesseStep step;
+} State;
+
+FinesseMove finesse_table[N_PIECES][4][KEY_COLUMNS];
+
+CitrusGame scratch;
+CitrusCell* scratch_board = NULL;
+const CitrusPiece** scratch_queue = NULL;
+const CitrusPiece* scratch_piece;
+int scratch_locks;
+CitrusCell empty_cell;
+// the cells on the scratch board that aren't empty, or -1 if there are too
+// many
+int n_drawn;
+int drawn[MAX_STATE_CELLS];
+
+State* states = NULL;
+int max_states;
+unsigned char* visited = NULL;
+int seen_shapes[MAX_SHAPES];
+int n_seen_shapes;
+
+// what is tried from each state, best first; a slide's hold_ticks is
+// worked out when it is tried
+const FinesseStep moves[] = {
+	{CITRUS_KEY_LEFT, 1, 0},
+	{CITRUS_KEY_RIGHT, 1, 0},
+	{CITRUS_KEY_CLOCKWISE, 1, 0},
+	{CITRUS_KEY_ANTICLOCKWISE, 1, 0},
+	{CITRUS_KEY_180, 1, 0},
+	{CITRUS_KEY_LEFT, 1, 1},
+	{CITRUS_KEY_RIGHT, 1, 1},
+};
+
+const CitrusPiece* same_piece(void* data) {
+	return *(const CitrusPiece**) data;
+}
+
+void count_lock(void* data, int n_lines_cleared, int combo, bool b2b, bool all_clear, bool spin, bool mini_spin) {
+	(void) data;
+	(void) n_lines_cleared;
+	(void) combo;
+	(void) b2b;
+	(void) all_clear;
+	(void) spin;
+	(void) mini_spin;
+	scratch_locks++;
+}
+
+void scratch_start(int piece) {
+	CitrusGameConfig scratch_config = config;
+	scratch_config.randomizer = same_piece;
+	scratch_config.action_text = count_lock;
+	scratch_piece = pieces_by_id[piece];
+	CitrusGame_init(&scratch, scratch_board, scratch_queue, scratch_config, &scratch_piece, NULL);
+	scratch_locks = 0;
+}
+
+void press_scratch(CitrusKey key) {
+	CitrusGame_key_down(&scratch, key);
+	CitrusGame_key_up(&scratch, key);
+}
+
+// where the full cells below a row are, which is the falling piece when
+// nothing else is on the board
+bool piece_position(const State* state, int rows, Position* position) {
+	int min_x = config.width, min_y = rows, max_x = -1, max_y = -1;
+	for (int i = 0; i < state->n_cells; i++) {
+		int x = state->cell_index[i] % config.width;
+		int y = state->cell_index[i] / config.width;
+		if (state->cells[i].type != CITRUS_CELL_FULL || y >= rows)
+			continue;
+		min_x = x < min_x ? x : min_x;
+		max_x = x > max_x ? x : max_x;
+		min_y = y < min_y ? y : min_y;
+		max_y = y > max_y ? y : max_y;
+	}
+	if (max_x < 0 || max_x - min_x >= 4 || max_y - min_y >= 4)
+		return false;
+	position->shape = 0;
+	position->x = min_x;
+	position->y = min_y;
+	for (int i = 0; i < state->n_cells; i++) {
+		int x = state->cell_index[i] % config.width;
+		int y = state->cell_index[i] / config.width;
+		if (state->cells[i].type == CITRUS_CELL_FULL && y < rows)
+			position->shape |= 1 << ((y - min_y) * 4 + x - min_x);
+	}
+	return true;
+}
+
+// saves the scratch game into a state, without working out where the
+// piece is
+bool save_cells(State* state) {
+	state->game = scratch;
+	state->n_cells = 0;
+	for (int i = 0; i < config.width * config.full_height; i++) {
+		if (scratch_board[i].type == CITRUS_CELL_EMPTY)
+			continue;
+		if (state->n_cells == MAX_STATE_CELLS) {
+			n_drawn = -1;
+			return false;
+		}
+		state->cell_index[state->n_cells] = i;
+		state->cells[state->n_cells] = scratch_board[i];
+		state->n_cells++;
+	}
+	n_drawn = state->n_cells;
+	memcpy(drawn, state->cell_index, sizeof(int) * n_drawn);
+	return true;
+}
+
+bool capture(State* state) {
+	return save_cells(state) && piece_position(state, config.full_height, &state->position);
+}
+
+void load(const State* state) {
+	if (scratch_locks > 0 || n_drawn == -1) {
+		// a piece locked, or there were too many cells to keep track
+		// of, so the whole board has to be cleared
+		for (int i = 0; i < config.width * config.full_height; i++)
+			scratch_board[i] = empty_cell;
+		scratch_locks = 0;
+	} else {
+		for (int i = 0; i < n_drawn; i++)
+			scratch_board[drawn[i]] = empty_cell;
+	}
+	for (int i = 0; i < state->n_cells; i++)
+		scratch_board[state->cell_index[i]] = state->cells[i];
+	n_drawn = state->n_cells;
+	memcpy(drawn, state->cell_index, sizeof(int) * n_drawn);
+	scratch = state->game;
+}
+
+int shape_width(int shape) {
+	int width = 0;
+	for (int i = 0; i < 16; i++) {
+		if ((shape >> i & 1) && i % 4 >= width)
+			width = i % 4 + 1;
+	}
+	return width;
+}
+
+// The left half of each row of keys puts the left edge of the piece in a
+// column, and the right half puts the right edge there. The key columns are
+// spread over the board, so that every part of a wide board can be reached,
+// and on a board 10 wide each key is its own column.
+int target_column(int column, int width) {
+	int edge = (2 * column * (config.width - 1) + KEY_COLUMNS - 1) / (2 * (KEY_COLUMNS - 1));
+	int x = column < KEY_COLUMNS / 2 ? edge : edge - (width - 1);
+	if (x > config.width - width)
+		x = config.width - width;
+	if (x < 0)
+		x = 0;
+	return x;
+}
+
+bool piece_at(int shape, int x, int y) {
+	for (int i = 0; i < 16; i++) {
+		if ((shape >> i & 1) == 0)
+			continue;
+		int cell_x = x + i % 4, cell_y = y + i / 4;
+		if (cell_x >= config.width || cell_y >= config.full_height
+			|| scratch_board[cell_y * config.width + cell_x].type != CITRUS_CELL_FULL)
+			return false;
+	}
+	return true;
+}
+
+// Finds where the piece is after a tick, by looking for its cells moved
+// sideways and down, which is much quicker than reading the whole board.
+bool follow(Position* position) {
+	for (int y = position->y; y >= 0; y--) {
+		if (piece_at(position->shape, position->x, y)) {
+			position->y = y;
+			return true;
+		}
+		for (int x = 0; x < config.width; x++) {
+			if (piece_at(position->shape, x, y)) {
+				position->x = x;
+				position->y = y;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// Holds the key of a slide until the piece stops moving, by reaching the
+// wall or locking, and then plays it again, letting go on the tick the
+// piece last moved so that it isn't held any longer than it has to be.
+bool try_slide(const State* from, CitrusKey key, State* next) {
+	int locks = scratch_locks;
+	CitrusGame_key_down(&scratch, key);
+	if (!capture(next))
+		return false;
+	Position position = next->position;
+	int wall = key == CITRUS_KEY_LEFT ? 0 : config.width - shape_width(position.shape);
+	int hold_ticks = 0;
+	int limit = config.das + config.width * (config.arr + 1) + 1;
+	for (int n = 1; n <= limit && position.x != wall; n++) {
+		int x = position.x;
+		CitrusGame_tick(&scratch);
+		if (scratch_locks != locks || !CitrusGame_is_alive(&scratch) || !follow(&position))
+			break;
+		if (position.x != x)
+			hold_ticks = n;
+	}
+	if (hold_ticks == 0)
+		return false;
+	load(from);
+	CitrusGame_key_down(&scratch, key);
+	for (int n = 0; n < hold_ticks; n++)
+		CitrusGame_tick(&scratch);
+	CitrusGame_key_up(&scratch, key);
+	if (!capture(next))
+		return false;
+	next->step.key = key;
+	next->step.count = 1;
+	next->step.hold_ticks = hold_ticks;
+	return true;
+}
+
+// plays a move from a state, and saves where it ends up
+bool try_move(const State* from, const FinesseStep* move, State* next) {
+	load(from);
+	int locks = scratch_locks;
+	if (move->hold_ticks > 0) {
+		if (!try_slide(from, move->key, next))
+			return false;
+	} else {
+		press_scratch(move->key);
+		if (!capture(next))
+			return false;
+		next->step = *move;
+	}
+	return scratch_locks == locks && CitrusGame_is_alive(&scratch);
+}
+
+// fills in the moves that end at a state, returning how many there were
+int reach(int piece, int index) {
+	const Position* position = &states[index].position;
+	int found = 0;
+	for (int rotation = 0; rotation < 4; rotation++) {
+		for (int column = 0; column < KEY_COLUMNS; column++) {
+			FinesseMove* move = &finesse_table[piece][rotation][column];
+			if (move->found || move->shape != position->shape || move->x != position->x)
+				continue;
+			// the steps back to the spawn, with repeated taps merged
+			FinesseStep path[MAX_FINESSE_STEPS];
+			int n = 0;
+			bool fits = true;
+			for (int i = index; states[i].parent != -1; i = states[i].parent) {
+				const FinesseStep* step = &states[i].step;
+				if (n > 0 && step->hold_ticks == 0 && path[n - 1].hold_ticks == 0 && path[n - 1].key == step->key) {
+					path[n - 1].count++;
+				} else if (n == MAX_FINESSE_STEPS) {
+					fits = false;
+					break;
+				} else {
+					path[n++] = *step;
+				}
+			}
+			if (!fits)
+				continue;
+			move->found = true;
+			move->n_steps = n;
+			for (int i = 0; i < n; i++)
+				move->steps[i] = path[n - 1 - i];
+			found++;
+		}
+	}
+	return found;
+}
+
+// returns false if the state has been seen before
+bool visit(const State* state) {
+	int shape = 0;
+	while (shape < n_seen_shapes && seen_shapes[shape] != state->position.shape)
+		shape++;
+	if (shape == n_seen_shapes) {
+		if (n_seen_shapes == MAX_SHAPES)
+			return false;
+		seen_shapes[n_seen_shapes++] = state->position.shape;
+	}
+	size_t i = ((size_t) shape * config.full_height + state->position.y) * config.width + state->position.x;
+	if (visited[i])
+		return false;
+	visited[i] = 1;
+	return true;
+}
+
+bool search(int piece) {
+	scratch_start(piece);
+	states[0].parent = -1;
+	if (!capture(&states[0]))
+		return false;
+	// what the piece looks like turned from the spawn, for the targets
+	int turned[4];
+	for (int rotation = 0; rotation < 4; rotation++) {
+		State* state = &states[1];
+		load(&states[0]);
+		for (int i = 0; i < rotation; i++)
+			press_scratch(CITRUS_KEY_CLOCKWISE);
+		if (!capture(state))
+			return false;
+		turned[rotation] = state->position.shape;
+	}
+	int to_find = 4 * KEY_COLUMNS;
+	for (int rotation = 0; rotation < 4; rotation++) {
+		for (int column = 0; column < KEY_COLUMNS; column++) {
+			FinesseMove* move = &finesse_table[piece][rotation][column];
+			move->found = false;
+			move->shape = turned[rotation];
+			move->x = target_column(column, shape_width(turned[rotation]));
+		}
+	}
+	memset(visited, 0, (size_t) MAX_SHAPES * config.width * config.full_height);
+	n_seen_shapes = 0;
+	visit(&states[0]);
+	to_find -= reach(piece, 0);
+	int n_states = 1;
+	for (int i = 0; i < n_states && to_find > 0; i++) {
+		for (size_t m = 0; m < sizeof(moves) / sizeof(moves[0]); m++) {
+			if (n_states == max_states) {
+				State* grown = realloc(states, sizeof(State) * max_states * 2);
+				if (grown == NULL)
+					return false;
+				states = grown;
+				max_states *= 2;
+			}
+			State* next = &states[n_states];
+			if (!try_move(&states[i], &moves[m], next) || !visit(next))
+				continue;
+			next->parent = i;
+			n_states++;
+			to_find -= reach(piece, n_states - 1);
+		}
+	}
+	return true;
+}
+
+// Builds the table for the current config. Keys whose target can't be
+// reached are left without a move.
+bool init_finesse(void) {
+	init_piece_table();
+	size_t n_cells = (size_t) config.width * config.full_height;
+	scratch_board = malloc(sizeof(CitrusCell) * n_cells);
+	scratch_queue = malloc(sizeof(CitrusPiece*) * (config.next_piece_queue_size + 1));
+	max_states = 1024;
+	states = malloc(sizeof(State) * max_states);
+	visited = malloc(MAX_SHAPES * n_cells);
+	bool ok = scratch_board != NULL && scratch_queue != NULL && states != NULL && visited != NULL;
+	if (ok) {
+		// a piece takes up less than the whole board, so some of it
+		// is empty at the start
+		scratch_start(0);
+		for (size_t i = 0; i < n_cells; i++) {
+			if (scratch_board[i].type == CITRUS_CELL_EMPTY)
+				empty_cell = scratch_board[i];
+		}
+	}
+	for (int piece = 0; piece < N_PIECES && ok; piece++)
+		ok = search(piece);
+	free(states);
+	free(visited);
+	states = NULL;
+	visited = NULL;
+	if (!ok)
+		free_finesse();
+	return ok;
+}
+
+// Plays every move in a new game, with the key held and the game ticking
+// the way it is in a real game, and counts the moves that don't put the
+// piece where the table says it goes.
+int check_finesse(int* n_moves) {
+	int failures = 0;
+	*n_moves = 0;
+	for (int piece = 0; piece < N_PIECES; piece++) {
+		for (int rotation = 0; rotation < 4; rotation++) {
+			for (int column = 0; column < KEY_COLUMNS; column++) {
+				const FinesseMove* move = &finesse_table[piece][rotation][column];
+				if (!move->found)
+					continue;
+				(*n_moves)++;
+				State spawn, before, after;
+				scratch_start(piece);
+				bool ok = capture(&spawn);
+				for (int i = 0; i < move->n_steps; i++) {
+					const FinesseStep* step = &move->steps[i];
+					if (step->hold_ticks > 0) {
+						CitrusGame_key_down(&scratch, step->key);
+						for (int n = 0; n < step->hold_ticks; n++)
+							CitrusGame_tick(&scratch);
+						CitrusGame_key_up(&scratch, step->key);
+					} else {
+						for (int n = 0; n < step->count; n++)
+							press_scratch(step->key);
+					}
+				}
+				ok = ok && scratch_locks == 0 && capture(&before)
+					&& before.position.shape == move->shape && before.position.x == move->x;
+				int lines = scratch.lines;
+				press_scratch(CITRUS_KEY_HARD_DROP);
+				ok = ok && scratch_locks == 1;
+				// the new piece is above the one that landed, unless
+				// the board is too short to tell them apart, and the
+				// landed piece is gone if it cleared a line
+				Position landed;
+				if (ok && scratch.lines == lines && spawn.position.y >= 4) {
+					ok = save_cells(&after) && piece_position(&after, spawn.position.y, &landed)
+						&& landed.shape == move->shape && landed.x == move->x && landed.y == 0;
+				}
+				if (!ok)
+					failures++;
+			}
+		}
+	}
+	return failures;
+}
+
+void free_finesse(void) {
+	free(scratch_board);
+	free(scratch_queue);
+	scratch_board = NULL;
+	scratch_queue = NULL;
+}
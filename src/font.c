@@ -0,0 +1,2194 @@
+/* Generated by `make font` from DejaVu Sans Mono at 16px.
+ * Copyright (c) 2003 by Bitstream, Inc. All Rights Reserved.
+ * DejaVu changes are in public domain
+ * Do not edit, change FONT and run `make font` again. */
+
+#include "font.h"
+
+const char font_glyphs[FONT_GLYPHS][FONT_HEIGHT][FONT_WIDTH + 1] = {
+	// ' '
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '!'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....e9....",
+		"....d8....",
+		"....c7....",
+		"..........",
+		"..........",
+		"....f9....",
+		"....f9....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '"'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..5f.5f...",
+		"..5f.5f...",
+		"..5f.5f...",
+		"..5f.5f...",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '#'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"...1f3.d6.",
+		"...5e.2f2.",
+		"...9a.6d..",
+		"1ffffffff9",
+		"..2f2.e4..",
+		"..5e.2f1..",
+		"..8b.6d...",
+		"ffffffffb.",
+		".2f2.e5...",
+		".6d.3f1...",
+		".a9.7c....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '$'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"....66....",
+		"....66....",
+		"..4beea4..",
+		".3f7674b..",
+		".7e.66....",
+		".6f366....",
+		"..bfda4...",
+		"...4adfb1.",
+		"....662e8.",
+		"....66.ca.",
+		".783675f5.",
+		".17ceec5..",
+		"....66....",
+		"....66....",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '%'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".9ec4.....",
+		"7b14e1....",
+		"a5..d3....",
+		"7b14e1..3.",
+		".9ed4.4ba.",
+		"....5c92..",
+		"..5c92....",
+		"2c82.8ed5.",
+		".1..5c13e2",
+		"....87..b5",
+		"....5c13e2",
+		".....8ed5.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '&'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..3cefc...",
+		"..e91.....",
+		".2f4......",
+		"..e9......",
+		"..9f3.....",
+		".6fdd1....",
+		"2f62e9..d5",
+		"7e..6f5.e4",
+		"8d...ae4f1",
+		"5f3..1dea.",
+		".cd413bf7.",
+		".19efd78f3",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '\''
+	{
+		"..........",
+		"..........",
+		"..........",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '('
+	{
+		"..........",
+		"..........",
+		"..........",
+		".....9a...",
+		"....3f2...",
+		"....ab....",
+		"...1f6....",
+		"...5f2....",
+		"...8f.....",
+		"...9d.....",
+		"...ad.....",
+		"...8f.....",
+		"...5f2....",
+		"...1f6....",
+		"....ab....",
+		"....3f2...",
+		".....9a...",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// ')'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..1e4.....",
+		"...8c.....",
+		"...2f4....",
+		"....ba....",
+		"....8e....",
+		"....5f3...",
+		"....4f4...",
+		"....4f4...",
+		"....5f3...",
+		"....8e....",
+		"....ba....",
+		"...2f4....",
+		"...8c.....",
+		"..1e4.....",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '*'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"....94....",
+		"....94....",
+		".692944b2.",
+		"..4adc82..",
+		"..4adc81..",
+		".692944b2.",
+		"....94....",
+		"....94....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '+'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"5fffffffe.",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// ','
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"...1fd....",
+		"...1fd....",
+		"...4f8....",
+		"...7f1....",
+		"...b9.....",
+		"..........",
+		"..........",
+	},
+	// '-'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..3fffd...",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '.'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"...3fc....",
+		"...3fc....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '/'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"......4f3.",
+		"......bb..",
+		".....3f4..",
+		".....bc...",
+		"....3f5...",
+		"....ad....",
+		"...2f5....",
+		"...9d.....",
+		"..1f6.....",
+		"..8e1.....",
+		".1e7......",
+		".7e1......",
+		"1e8.......",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '0'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..2bee8...",
+		".1da13e9..",
+		".7f1..7f1.",
+		".bc...3f5.",
+		".da...1f8.",
+		".ea1d9.f9.",
+		".ea1e9.f9.",
+		".da...1f8.",
+		".bc...3f5.",
+		".7f1..7f1.",
+		".1da13e9..",
+		"..2bee8...",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '1'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..39ef2...",
+		".1c67f2...",
+		"....7f2...",
+		"....7f2...",
+		"....7f2...",
+		"....7f2...",
+		"....7f2...",
+		"....7f2...",
+		"....7f2...",
+		"....7f2...",
+		"....7f2...",
+		"..dfffff8.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '2'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".29dec6...",
+		".bc414e9..",
+		".71...8f1.",
+		"......7f3.",
+		"......af1.",
+		".....4f9..",
+		"....1dd1..",
+		"....be2...",
+		"...ae3....",
+		"..8f5.....",
+		".6f6......",
+		".cffffff4.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '3'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".17ced71..",
+		".77214ea..",
+		"......8f1.",
+		"......7f1.",
+		".....4ea..",
+		"...effa...",
+		"....14ea..",
+		"......5f4.",
+		"......3f6.",
+		"......5f4.",
+		".b5214dc..",
+		".3aded81..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '4'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".....cf5..",
+		"....7ef5..",
+		"...2e7f5..",
+		"...b94f5..",
+		"..5e14f5..",
+		".1e7.4f5..",
+		".9d..4f5..",
+		"2f5..4f5..",
+		"3fffffffd.",
+		".....4f5..",
+		".....4f5..",
+		".....4f5..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '5'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".6fffff8..",
+		".6f1......",
+		".6f1......",
+		".6f1......",
+		".6fefd7...",
+		".57117f9..",
+		"......9f2.",
+		"......5f5.",
+		"......5f5.",
+		"......8f2.",
+		".a5116f9..",
+		".3befd7...",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '6'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..18dfb3..",
+		"..bc3.38..",
+		".5f2......",
+		".ab.......",
+		".d98eeb2..",
+		".eea12bd..",
+		".ee1..3f6.",
+		".dc....f8.",
+		".bc....f8.",
+		".7e1..3f5.",
+		".1ea12bd..",
+		"..3beeb2..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '7'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".effffff6.",
+		"......8f2.",
+		"......dc..",
+		".....4f6..",
+		".....9f1..",
+		"....1ea...",
+		"....5f4...",
+		"....be....",
+		"...2f8....",
+		"...7f3....",
+		"...dc.....",
+		"..3f7.....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '8'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..5ceea2..",
+		".4f812cd1.",
+		".9e...5f4.",
+		".9e...5f4.",
+		".3e712cb..",
+		"..4effb1..",
+		".4f712bc1.",
+		".cc...2f6.",
+		".ea....f9.",
+		".cc...2f7.",
+		".6f712be2.",
+		"..6ceea2..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '9'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..6dfd8...",
+		".5f614e9..",
+		".cc...7f1.",
+		".e9...4f5.",
+		".e9...4f7.",
+		".cc...7f8.",
+		".5f614df8.",
+		"..6dfd4e7.",
+		"......2f4.",
+		"......7e..",
+		".28216f5..",
+		"..7dec5...",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// ':'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"...3fc....",
+		"...3fc....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"...3fc....",
+		"...3fc....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// ';'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"...3fc....",
+		"...3fc....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"...1fd....",
+		"...1fd....",
+		"...4f8....",
+		"...7f1....",
+		"...b9.....",
+		"..........",
+		"..........",
+	},
+	// '<'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"......16c.",
+		"....39ee9.",
+		".16cfc61..",
+		"3ee83.....",
+		"3ee82.....",
+		".16cfc61..",
+		"....39ee9.",
+		"......16c.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '='
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"5fffffffe.",
+		"..........",
+		"..........",
+		"5fffffffe.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '>'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"4a4.......",
+		"2cfd71....",
+		"..28efa4..",
+		".....5afc.",
+		".....4afc.",
+		"..28efa4..",
+		"2cfd71....",
+		"4a4.......",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '?'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..4beea2..",
+		".1a413dc..",
+		"......8f1.",
+		"......be..",
+		".....9f5..",
+		"....6f6...",
+		"....e9....",
+		"...2f6....",
+		"...2f5....",
+		"..........",
+		"...3f6....",
+		"...3f6....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '@'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..18dfd7..",
+		".1da3.3c9.",
+		".aa....2f1",
+		"3e1.5de8e3",
+		"7a.2f51af3",
+		"a7.8a..2f3",
+		"b6.b7...e3",
+		"b6.b7...e3",
+		"a8.8a..2f3",
+		"7b.2e51af3",
+		"2f2.5de8e3",
+		".8c1......",
+		"..ac41....",
+		"...5befc1.",
+		"..........",
+		"..........",
+	},
+	// 'A'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"...4fe....",
+		"...9ef3...",
+		"...d9e8...",
+		"..3f5ac...",
+		"..7f16f2..",
+		"..cc.2f6..",
+		".1f8..eb..",
+		".6f4..af1.",
+		".affffff5.",
+		".e9...1e9.",
+		"4f5....bd.",
+		"8f1....6f3",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'B'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".bfffeb3..",
+		".bd..2ae2.",
+		".bd...3f6.",
+		".bd...3f6.",
+		".bd..2be2.",
+		".bffffd4..",
+		".bd..29e3.",
+		".bd....da.",
+		".bd....bd.",
+		".bd....dc.",
+		".bd..18f6.",
+		".bfffec5..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'C'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"...6ced81.",
+		"..8e513c6.",
+		".3f6...14.",
+		".9f1......",
+		".cc.......",
+		".db.......",
+		".db.......",
+		".cc.......",
+		".9f1......",
+		".3f6...14.",
+		"..9e513c6.",
+		"...6cfd81.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'D'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".effea4...",
+		".ea.28f5..",
+		".ea...9e1.",
+		".ea...4f5.",
+		".ea...1f8.",
+		".ea...1f9.",
+		".ea....f9.",
+		".ea...1f8.",
+		".ea...4f5.",
+		".ea...9e1.",
+		".ea.28f5..",
+		".effea4...",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'E'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".7ffffff7.",
+		".7f2......",
+		".7f2......",
+		".7f2......",
+		".7f2......",
+		".7ffffff4.",
+		".7f2......",
+		".7f2......",
+		".7f2......",
+		".7f2......",
+		".7f2......",
+		".7ffffff9.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'F'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".3ffffffa.",
+		".3f6......",
+		".3f6......",
+		".3f6......",
+		".3f6......",
+		".3ffffff3.",
+		".3f6......",
+		".3f6......",
+		".3f6......",
+		".3f6......",
+		".3f6......",
+		".3f6......",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'G'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..18dfc6..",
+		"..cc3.4d4.",
+		".7f2...23.",
+		".db.......",
+		"1f8.......",
+		"3f7.......",
+		"3f7..9ff9.",
+		"1f8....d9.",
+		".db....d9.",
+		".8f2...d9.",
+		".1cc3.3e9.",
+		"..18dfd92.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'H'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".ea....f8.",
+		".ea....f8.",
+		".ea....f8.",
+		".ea....f8.",
+		".ea....f8.",
+		".effffff8.",
+		".ea....f8.",
+		".ea....f8.",
+		".ea....f8.",
+		".ea....f8.",
+		".ea....f8.",
+		".ea....f8.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'I'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".6ffffff1.",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		".6ffffff1.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'J'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..1ffff7..",
+		".....2f7..",
+		".....2f7..",
+		".....2f7..",
+		".....2f7..",
+		".....2f7..",
+		".....2f7..",
+		".....2f7..",
+		".....2f6..",
+		"24...4f4..",
+		"2f612cd...",
+		".5beeb3...",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'K'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".ea...1cd2",
+		".ea..1be2.",
+		".ea..be3..",
+		".ea.ae4...",
+		".ea8f4....",
+		".eeff4....",
+		".ef6cd1...",
+		".ea.3f9...",
+		".ea..8f4..",
+		".ea..1dd1.",
+		".ea...4f9.",
+		".ea....af4",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'L'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".5f4......",
+		".5f4......",
+		".5f4......",
+		".5f4......",
+		".5f4......",
+		".5f4......",
+		".5f4......",
+		".5f4......",
+		".5f4......",
+		".5f4......",
+		".5f4......",
+		".5ffffffe.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'M'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"5fe...5fe.",
+		"5fe4..aee.",
+		"5fa9..eae.",
+		"5f5d.4d8e.",
+		"5f2d3988e.",
+		"5f298e38e.",
+		"5f24fd.8e.",
+		"5f2.e8.8e.",
+		"5f2....8e.",
+		"5f2....8e.",
+		"5f2....8e.",
+		"5f2....8e.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'N'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".ef4...f8.",
+		".efa...f8.",
+		".edf2..f8.",
+		".e9d7..f8.",
+		".e97d..f8.",
+		".e91f4.f8.",
+		".e9.aa.f8.",
+		".e9.4f1f8.",
+		".e9..d7f8.",
+		".e9..7df8.",
+		".e9..1ff8.",
+		".e9...af8.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'O'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..3cee91..",
+		".2e912db..",
+		".9e...5f3.",
+		".db...1f7.",
+		".f9....fa.",
+		"1f9....ea.",
+		"1f9....ea.",
+		".f9....fa.",
+		".db...1f7.",
+		".9e...5f3.",
+		".2e912db..",
+		"..3cfe91..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'P'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".7fffec5..",
+		".7f2.19f6.",
+		".7f2...ec.",
+		".7f2...cd.",
+		".7f2...eb.",
+		".7f2.19f5.",
+		".7fffec5..",
+		".7f2......",
+		".7f2......",
+		".7f2......",
+		".7f2......",
+		".7f2......",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'Q'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..3cee91..",
+		".2e912db..",
+		".9e...5f3.",
+		".db...1f7.",
+		".f9....f9.",
+		"1f9....ea.",
+		"1f9....ea.",
+		".f9....f9.",
+		".db...1f7.",
+		".9e...5f4.",
+		".2e912db..",
+		"..3cffd1..",
+		".....6f6..",
+		"......89..",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'R'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".dfffd81..",
+		".db..4eb..",
+		".db...8f3.",
+		".db...5f5.",
+		".db...7f3.",
+		".db..4ea..",
+		".dffff8...",
+		".db.17f4..",
+		".db...bd..",
+		".db...3f6.",
+		".db....bd.",
+		".db....4f6",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'S'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..4beea3..",
+		".5f7119e..",
+		".cb....6..",
+		".da.......",
+		".ae3......",
+		".2cfc83...",
+		"...48cfa..",
+		"......6f5.",
+		".......f8.",
+		".7....1f7.",
+		".cc4.2be2.",
+		".29dfda3..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'T'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"9ffffffff4",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'U'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".db...1f7.",
+		".db...1f7.",
+		".db...1f7.",
+		".db...1f7.",
+		".db...1f7.",
+		".db...1f7.",
+		".db...1f7.",
+		".db...1f7.",
+		".cb...1f7.",
+		".ac...3f5.",
+		".5f712be1.",
+		"..5ceea2..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'V'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"6f3....9f1",
+		"2f7....cb.",
+		".db...1f7.",
+		".8e...5f3.",
+		".4f3..9e..",
+		"..e7..d9..",
+		"..bb.2f5..",
+		"..6f.6f1..",
+		"..2f4ac...",
+		"...d8d7...",
+		"...9df3...",
+		"...4fe....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'W'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"e9......e8",
+		"cb.....1f6",
+		"ad.....3f4",
+		"7e.2fb.5f2",
+		"5f15fe.6f.",
+		"3f38af28d.",
+		"1f4b6c5aa.",
+		".e6e398c8.",
+		".b9e.5bd6.",
+		".9ec.2ef4.",
+		".7f8..ef2.",
+		".5f5..be..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'X'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"1ea....bd1",
+		".6f3..5f5.",
+		"..cc..da..",
+		"..4f57e2..",
+		"...ade7...",
+		"...2fd....",
+		"...7ff4...",
+		"..2e8ac...",
+		"..bd12f6..",
+		".5f5..9e1.",
+		"1db...1e9.",
+		"8f2....7f3",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'Y'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"6f4....9e2",
+		".dc...2f7.",
+		".4f5..ad1.",
+		"..bd.3f5..",
+		"..3f6bc...",
+		"...9ef4...",
+		"...1fb....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"....f9....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'Z'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".9fffffff.",
+		"......3fc.",
+		"......bf3.",
+		".....6f9..",
+		"....1ed1..",
+		"....9f5...",
+		"...3fa....",
+		"...ce2....",
+		"..6f7.....",
+		".1ec......",
+		".9f3......",
+		".cfffffff2",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '['
+	{
+		"..........",
+		"..........",
+		"..........",
+		"...6ffe...",
+		"...6f1....",
+		"...6f1....",
+		"...6f1....",
+		"...6f1....",
+		"...6f1....",
+		"...6f1....",
+		"...6f1....",
+		"...6f1....",
+		"...6f1....",
+		"...6f1....",
+		"...6f1....",
+		"...6f1....",
+		"...6ffe...",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '\\'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"1e8.......",
+		".7e1......",
+		".1e7......",
+		"..8e1.....",
+		"..2f6.....",
+		"...9d.....",
+		"...2f5....",
+		"....ad....",
+		"....3f5...",
+		".....bc...",
+		".....3f4..",
+		"......bb..",
+		"......4f3.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// ']'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..4fff....",
+		"....6f....",
+		"....6f....",
+		"....6f....",
+		"....6f....",
+		"....6f....",
+		"....6f....",
+		"....6f....",
+		"....6f....",
+		"....6f....",
+		"....6f....",
+		"....6f....",
+		"....6f....",
+		"..4fff....",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '^'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"...5fd1...",
+		"..4f8cc1..",
+		".3e7.1cb..",
+		"2d7...1c9.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '_'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"fffffffffa",
+		"..........",
+	},
+	// '`'
+	{
+		"..........",
+		"..........",
+		"..6e2.....",
+		"...8c.....",
+		"....a8....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'a'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..6ceea2..",
+		".493.2bd..",
+		"......3f3.",
+		"..6cefff4.",
+		".7e51.3f4.",
+		".d9...5f4.",
+		".d8...9f4.",
+		".9e316ef4.",
+		".19eeb5f4.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'b'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".7e.......",
+		".7e.......",
+		".7e.......",
+		".7e5dfb3..",
+		".7fc22bd..",
+		".7f4..2f6.",
+		".7f1...e9.",
+		".7f....da.",
+		".7f1...e8.",
+		".7f4..2f6.",
+		".7fc22bd..",
+		".7e6dfb3..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'c'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"...6cfd8..",
+		"..8e61264.",
+		".2f7......",
+		".6f2......",
+		".7f1......",
+		".6f3......",
+		".2f7......",
+		"..8e61264.",
+		"...6cfd8..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'd'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"......4f2.",
+		"......4f2.",
+		"......4f2.",
+		"..6dfc7f2.",
+		".4f715ef2.",
+		".bc...9f2.",
+		".e9...6f2.",
+		".f8...5f2.",
+		".e9...6f2.",
+		".bc...9f2.",
+		".4f615ef2.",
+		"..6dfc7f2.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'e'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..2aeeb2..",
+		".2ea21ad..",
+		".ad...1e6.",
+		".e9....c9.",
+		".fffffffa.",
+		".e8.......",
+		".ac.......",
+		".2e921395.",
+		"..3aeec6..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'f'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"....5dff5.",
+		"....e8....",
+		"...2f5....",
+		".7ffffff5.",
+		"...2f4....",
+		"...2f4....",
+		"...2f4....",
+		"...2f4....",
+		"...2f4....",
+		"...2f4....",
+		"...2f4....",
+		"...2f4....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'g'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..5dfc7f2.",
+		".4f715ef2.",
+		".bc...9f2.",
+		".e9...6f2.",
+		".f8...5f2.",
+		".e9...6f2.",
+		".bc...9f2.",
+		".4f714ef2.",
+		"..6dfc7f2.",
+		"......6f..",
+		".1a313d9..",
+		"..5ced81..",
+		"..........",
+		"..........",
+	},
+	// 'h'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".7f.......",
+		".7f.......",
+		".7f.......",
+		".7f4cfc3..",
+		".7fb21cd..",
+		".7f3..5f2.",
+		".7f...4f3.",
+		".7f...4f3.",
+		".7f...4f3.",
+		".7f...4f3.",
+		".7f...4f3.",
+		".7f...4f3.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'i'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"....ba....",
+		"....ba....",
+		"..........",
+		"..fffa....",
+		"....ba....",
+		"....ba....",
+		"....ba....",
+		"....ba....",
+		"....ba....",
+		"....ba....",
+		"....ba....",
+		".9ffffff8.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'j'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"....5f2...",
+		"....5f2...",
+		"..........",
+		"..cfff2...",
+		"....5f2...",
+		"....5f2...",
+		"....5f2...",
+		"....5f2...",
+		"....5f2...",
+		"....5f2...",
+		"....5f2...",
+		"....5f2...",
+		"....6f1...",
+		"...1bc....",
+		".8ffc3....",
+		"..........",
+		"..........",
+	},
+	// 'k'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".2f5......",
+		".2f5......",
+		".2f5......",
+		".2f5..6f5.",
+		".2f5.6f5..",
+		".2f56f5...",
+		".2fbf9....",
+		".2ffaf3...",
+		".2f6.cd1..",
+		".2f5.2e9..",
+		".2f5..6f5.",
+		".2f5...be2",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'l'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".bfff.....",
+		"...7f.....",
+		"...7f.....",
+		"...7f.....",
+		"...7f.....",
+		"...7f.....",
+		"...7f.....",
+		"...7f.....",
+		"...7f.....",
+		"...6f1....",
+		"...2f7....",
+		"....6dff1.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'm'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"2faec6ed3.",
+		"2f72fc1aa.",
+		"2f3.d8.7c.",
+		"2f2.c8.7d.",
+		"2f2.c8.7d.",
+		"2f2.c8.7d.",
+		"2f2.c8.7d.",
+		"2f2.c8.7d.",
+		"2f2.c8.7d.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'n'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		".7f4cfc3..",
+		".7fb21cd..",
+		".7f3..5f2.",
+		".7f...4f3.",
+		".7f...4f3.",
+		".7f...4f3.",
+		".7f...4f3.",
+		".7f...4f3.",
+		".7f...4f3.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'o'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..4cfea1..",
+		".3f913dc..",
+		".ae...4f4.",
+		".da...1f7.",
+		".e9....f8.",
+		".da...1f7.",
+		".ae...4f4.",
+		".3f913dc..",
+		"..4cfea1..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'p'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		".8e6dfb2..",
+		".8fc22bd..",
+		".8f4..2f5.",
+		".8f....e8.",
+		".8e....d9.",
+		".8f....e8.",
+		".8f4..2f5.",
+		".8fc22bd..",
+		".8e7dfb2..",
+		".8e.......",
+		".8e.......",
+		".8e.......",
+		"..........",
+		"..........",
+	},
+	// 'q'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..5dfc7f4.",
+		".2f814ef4.",
+		".9d...8f4.",
+		".ca...4f4.",
+		".d9...3f4.",
+		".ca...4f4.",
+		".9d...8f4.",
+		".3f814ef4.",
+		"..5dfc7f4.",
+		"......3f4.",
+		"......3f4.",
+		"......3f4.",
+		"..........",
+		"..........",
+	},
+	// 'r'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..3f48ee7.",
+		"..3fc8228.",
+		"..3fb.....",
+		"..3f6.....",
+		"..3f5.....",
+		"..3f4.....",
+		"..3f4.....",
+		"..3f4.....",
+		"..3f4.....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 's'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..3bee92..",
+		".1e91157..",
+		".4f3......",
+		".2fb41....",
+		"..4cffc3..",
+		"....15dd..",
+		"......7f..",
+		".59312cb..",
+		"..6ced91..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 't'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"...ac.....",
+		"...ac.....",
+		".fffffff1.",
+		"...ac.....",
+		"...ac.....",
+		"...ac.....",
+		"...ac.....",
+		"...ac.....",
+		"...9d.....",
+		"...6f4....",
+		"....9eff1.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'u'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		".7f...4f3.",
+		".7f...4f3.",
+		".7f...4f3.",
+		".7f...4f3.",
+		".7f...4f3.",
+		".7f...4f3.",
+		".6f1..7f3.",
+		".2f813df3.",
+		"..6dfb6f3.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'v'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"1f7....ca.",
+		".bc...2f5.",
+		".5f2..7e1.",
+		".1e7..ca..",
+		"..ac.2f5..",
+		"..5f27e...",
+		"...e7d9...",
+		"...9ef4...",
+		"...4fe....",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'w'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"d8......d8",
+		"ab.....1f4",
+		"7e.....5f1",
+		"3f2.e8.8d.",
+		".e53dd.b9.",
+		".b887d2e6.",
+		".8cc389f2.",
+		".4fd.4fe..",
+		".1f9..eb..",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'x'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		".bc...4f6.",
+		".1e9.1da..",
+		"..4f4ad1..",
+		"...8ef3...",
+		"...3fc....",
+		"...cce7...",
+		"..9e26f3..",
+		".5f5..ad1.",
+		"2e9...1ea.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// 'y'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"1e8....bc.",
+		".9d...1f7.",
+		".3f4..6f1.",
+		"..c9..ca..",
+		"..7e12f4..",
+		"..1f68d...",
+		"...abd8...",
+		"...4ff2...",
+		"....eb....",
+		"...2f5....",
+		"..1ad.....",
+		".8fc3.....",
+		"..........",
+		"..........",
+	},
+	// 'z'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		".3ffffff2.",
+		"......be1.",
+		".....8f4..",
+		"....4f8...",
+		"...2eb....",
+		"...ce1....",
+		"..9f4.....",
+		".4f7......",
+		".6ffffff2.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+	// '{'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"....3bee..",
+		"....ad2...",
+		"....da....",
+		"....d9....",
+		"....d9....",
+		"....e8....",
+		"..16f5....",
+		".4ff9.....",
+		"..16f5....",
+		"....e8....",
+		"....d9....",
+		"....d9....",
+		"....da....",
+		"....ad2...",
+		"....3bee..",
+		"..........",
+		"..........",
+	},
+	// '|'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"....d7....",
+		"..........",
+	},
+	// '}'
+	{
+		"..........",
+		"..........",
+		"..........",
+		".4fe9.....",
+		"...5f4....",
+		"....f7....",
+		"....f7....",
+		"....f7....",
+		"....e8....",
+		"....ad3...",
+		"....2dfe..",
+		"....ad2...",
+		"....e8....",
+		"....f7....",
+		"....f7....",
+		"....f7....",
+		"...5f4....",
+		".4fe9.....",
+		"..........",
+		"..........",
+	},
+	// '~'
+	{
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"19dea513a.",
+		"47216bec5.",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+		"..........",
+	},
+};
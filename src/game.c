@@ -0,0 +1,678 @@
+/* Copyright (C) 2025-2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "game.h"
+#include "profile.h"
+
+Backend backend;
+const CitrusPiece** next_piece_queue;
+CitrusGameConfig config;
+CitrusCell* board;
+CitrusGame game;
+void* randomizer;
+Window board_win, next_piece_win, hold_win, minimap_win, opponent_win;
+int pieces = 0;
+int ticks = 0;
+int attack = 0;
+int tick_rate = 60;
+// set while playing against a bot
+const View* opponent_view = NULL;
+
+// what is currently on screen, so that update() only redraws what changed
+int* drawn_board;
+const CitrusPiece* drawn_hold;
+const CitrusPiece** drawn_next_pieces;
+const CitrusPiece** view_next_pieces;
+// the HUD under the hold piece, the opponent's HUD, then the stats overlay
+#define STATS_LINE (HUD_LINES + OPPONENT_HUD_LINES)
+char drawn_hud[STATS_LINE + N_PHASES][HUD_LINE_SIZE];
+bool show_stats = false;
+bool show_minimap = false;
+bool frame_valid = false;
+bool show_action_text = true;
+// action text is drawn with the next frame rather than straight away, so
+// that only whatever draws frames uses the backend
+char action_text[ACTION_TEXT_SIZE];
+int action_text_count = 0;
+int drawn_action_text_count = 0;
+int drawn_opponent_action_text_count = 0;
+GameHooks game_hooks = {0};
+
+// Boards bigger than the screen are drawn through a viewport that follows
+// the falling piece. drawn_board holds the colors of the viewport's cells,
+// and seen_board the board rows they were drawn from, so that rows that
+// haven't changed are skipped with a memcmp.
+int view_x = 0;
+int view_y = 0;
+int view_columns;
+int view_rows;
+CitrusCell* seen_board;
+CitrusCell* empty_row;
+int minimap_scale;
+int minimap_columns;
+int minimap_rows;
+int drawn_minimap_pieces;
+// the same for the opponent's board
+int* drawn_opponent;
+int opponent_x = 0;
+int opponent_y = 0;
+int stats_x;
+
+const Preset presets[N_PRESETS] = {
+	{"modern", &citrus_preset_modern},
+	{"classic", &citrus_preset_classic},
+	{"delayless", &citrus_preset_delayless},
+};
+
+const char* clear_names[5] = {"", "Single", "Double", "Triple", "Quad"};
+const int attack_table[5] = {0, 0, 1, 2, 4};
+const int combo_table[12] = {0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 4, 5};
+
+int cell_color(CitrusCell cell) {
+	if (cell.type == CITRUS_CELL_FULL)
+		return cell.color + 2;
+	else if (cell.type == CITRUS_CELL_SHADOW)
+		return 1;
+	else
+		return 0;
+}
+
+// Pieces and cells are sent over the network as numbers. A piece's number is
+// the color of its cells, and cells use the same numbers as the backends.
+const CitrusPiece* pieces_by_id[N_PIECES];
+CitrusCell cells_by_color[N_PIECES + 2];
+
+int piece_id(const CitrusPiece* piece) {
+	for (int i = 0; i < piece->width * piece->height; i++) {
+		if (piece->piece_data[i].type == CITRUS_CELL_FULL)
+			return piece->piece_data[i].color;
+	}
+	return 0;
+}
+
+// libcitrus doesn't list its pieces, so find them by starting a game with
+// enough of the bag visible
+void init_piece_table(void) {
+	CitrusGameConfig piece_config = citrus_preset_modern;
+	piece_config.next_piece_queue_size = N_PIECES * 2;
+	piece_config.action_text = NULL;
+	CitrusBagRandomizer bag;
+	CitrusBagRandomizer_init(&bag, 0);
+	CitrusCell* piece_board = malloc(sizeof(CitrusCell) * piece_config.full_height * piece_config.width);
+	const CitrusPiece* queue[N_PIECES * 2];
+	CitrusGame piece_game;
+	CitrusGame_init(&piece_game, piece_board, queue, piece_config, &bag, NULL);
+	// the bottom left corner is empty at the start of a game
+	cells_by_color[0] = piece_board[0];
+	cells_by_color[1] = piece_board[0];
+	cells_by_color[1].type = CITRUS_CELL_SHADOW;
+	for (int i = 0; i < N_PIECES * 2; i++) {
+		const CitrusPiece* piece = CitrusGame_get_next_piece(&piece_game, i);
+		int id = piece_id(piece);
+		pieces_by_id[id] = piece;
+		for (int j = 0; j < piece->width * piece->height; j++) {
+			if (piece->piece_data[j].type == CITRUS_CELL_FULL)
+				cells_by_color[id + 2] = piece->piece_data[j];
+		}
+	}
+	free(piece_board);
+}
+
+void update_window(Window win, const CitrusCell* data, int height, int width, int y_offset, int x_offset) {
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			int color = cell_color(data[y * width + x]);
+			backend.draw_cell(win, x * 2 + x_offset + 1, height - y + y_offset, color);
+		}
+	}
+	backend.draw_box(win);
+	backend.update(win);
+}
+
+bool row_empty(const CitrusCell* row) {
+	if (memcmp(row, empty_row, sizeof(CitrusCell) * config.width) == 0)
+		return true;
+	for (int x = 0; x < config.width; x++) {
+		if (row[x].type == CITRUS_CELL_FULL)
+			return false;
+	}
+	return true;
+}
+
+// libcitrus doesn't say where the falling piece is, but it is almost always
+// the highest thing on the board. The viewport only scrolls once it gets
+// near the edge. Returns true if the viewport moved.
+bool follow_piece(const View* view, int* view_x, int* view_y) {
+	int top = config.full_height - 1;
+	while (top > 0 && row_empty(view->board + top * config.width))
+		top--;
+	int old_x = *view_x, old_y = *view_y;
+	int margin = view_rows / 4;
+	if (top >= *view_y + view_rows - margin || top < *view_y + margin)
+		*view_y = top - view_rows * 3 / 4;
+	const CitrusCell* row = view->board + top * config.width;
+	int left = config.width, right = 0;
+	for (int x = 0; x < config.width; x++) {
+		if (row[x].type == CITRUS_CELL_FULL) {
+			if (x < left)
+				left = x;
+			right = x;
+		}
+	}
+	if (left <= right) {
+		int centre = (left + right) / 2;
+		margin = view_columns / 4;
+		if (centre < *view_x + margin || centre >= *view_x + view_columns - margin)
+			*view_x = centre - view_columns / 2;
+	}
+	if (*view_y > config.full_height - view_rows)
+		*view_y = config.full_height - view_rows;
+	if (*view_y < 0)
+		*view_y = 0;
+	if (*view_x > config.width - view_columns)
+		*view_x = config.width - view_columns;
+	if (*view_x < 0)
+		*view_x = 0;
+	return *view_x != old_x || *view_y != old_y;
+}
+
+// only draws the board cells that differ from what is already on screen
+bool update_board(const View* view) {
+	bool changed = false;
+	bool all_rows = follow_piece(view, &view_x, &view_y) || !frame_valid;
+	for (int vy = 0; vy < view_rows; vy++) {
+		int y = view_y + vy;
+		const CitrusCell* row = view->board + y * config.width;
+		CitrusCell* seen = seen_board + y * config.width;
+		if (!all_rows && memcmp(row, seen, sizeof(CitrusCell) * config.width) == 0)
+			continue;
+		memcpy(seen, row, sizeof(CitrusCell) * config.width);
+		for (int vx = 0; vx < view_columns; vx++) {
+			int color = cell_color(row[view_x + vx]);
+			int i = vy * view_columns + vx;
+			if (drawn_board[i] != color) {
+				backend.draw_cell(board_win, vx * 2 + 1, view_rows - vy, color);
+				drawn_board[i] = color;
+				changed = true;
+			}
+		}
+	}
+	return changed;
+}
+
+// The opponent's board is small enough to just compare every cell with
+// what was drawn.
+bool update_opponent(const View* view) {
+	bool changed = false;
+	bool all_cells = follow_piece(view, &opponent_x, &opponent_y) || !frame_valid;
+	for (int vy = 0; vy < view_rows; vy++) {
+		const CitrusCell* row = view->board + (opponent_y + vy) * config.width;
+		for (int vx = 0; vx < view_columns; vx++) {
+			int color = cell_color(row[opponent_x + vx]);
+			int i = vy * view_columns + vx;
+			if (all_cells || drawn_opponent[i] != color) {
+				backend.draw_cell(opponent_win, vx * 2 + 1, view_rows - vy, color);
+				drawn_opponent[i] = color;
+				changed = true;
+			}
+		}
+	}
+	if (changed) {
+		backend.draw_box(opponent_win);
+		backend.update(opponent_win);
+	}
+	return changed;
+}
+
+// Draws the whole board shrunk down, with each cell showing the color of
+// the first full cell in its block of the board. This is only done when a
+// piece locks.
+void update_minimap(const View* view) {
+	backend.erase_window(minimap_win);
+	for (int my = 0; my < minimap_rows; my++) {
+		int colors[minimap_columns];
+		for (int mx = 0; mx < minimap_columns; mx++)
+			colors[mx] = 0;
+		for (int y = my * minimap_scale; y < (my + 1) * minimap_scale && y < config.full_height; y++) {
+			const CitrusCell* row = view->board + y * config.width;
+			if (row_empty(row))
+				continue;
+			for (int x = 0; x < config.width; x++) {
+				int mx = x / minimap_scale;
+				if (colors[mx] == 0 && row[x].type == CITRUS_CELL_FULL)
+					colors[mx] = cell_color(row[x]);
+			}
+		}
+		for (int mx = 0; mx < minimap_columns; mx++) {
+			if (colors[mx] != 0)
+				backend.draw_cell(minimap_win, mx * 2 + 1, minimap_rows - my, colors[mx]);
+		}
+	}
+	backend.draw_box(minimap_win);
+	backend.update(minimap_win);
+	drawn_minimap_pieces = view->pieces;
+}
+
+void update_hold(const View* view) {
+	const CitrusPiece* piece = view->hold_piece;
+	if (piece == NULL) {
+		update_window(hold_win, NULL, 0, 0, 0, 0);
+	} else {
+		const CitrusCell* data = piece->piece_data;
+		int height = piece->height;
+		int width = piece->width;
+		update_window(hold_win, data, height, width, height >= 4 ? 0 : 1, 4 - height);
+	}
+	drawn_hold = piece;
+}
+
+void update_next_pieces(const View* view) {
+	for (int i = 0; i < config.next_piece_queue_size; i++) {
+		const CitrusPiece* piece = view->next_pieces[i];
+		const CitrusCell* data = piece->piece_data;
+		int height = piece->height;
+		int width = piece->width;
+		update_window(next_piece_win, data, height, width, (height >= 4 ? 0 : 1) + i * 4, 4 - height);
+		drawn_next_pieces[i] = piece;
+	}
+}
+
+bool next_pieces_changed(const View* view) {
+	for (int i = 0; i < config.next_piece_queue_size; i++) {
+		if (drawn_next_pieces[i] != view->next_pieces[i])
+			return true;
+	}
+	return false;
+}
+
+bool update_hud_line(int line, const char* fmt, ...) {
+	char buffer[HUD_LINE_SIZE];
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(buffer, sizeof(buffer), fmt, args);
+	va_end(args);
+	if (frame_valid && strcmp(buffer, drawn_hud[line]) == 0)
+		return false;
+	// pad with spaces so that nothing is left over from a longer line
+	int length = strlen(drawn_hud[line]);
+	if (line < HUD_LINES) {
+		// cut off where the board starts, or the line and its padding
+		// would be drawn over the edge of the board
+		int room = board_win.x - hold_win.x;
+		if (length > room)
+			length = room;
+		backend.print(hold_win.y + hold_win.height + 1 + line, hold_win.x, "%-*.*s", length, room, buffer);
+	} else if (line < STATS_LINE)
+		backend.print(opponent_win.y + line - HUD_LINES, opponent_win.x + opponent_win.width + 2, "%-*s", length, buffer);
+	else
+		backend.print(next_piece_win.y + line - STATS_LINE, stats_x, "%-*s", length, buffer);
+	strcpy(drawn_hud[line], buffer);
+	return true;
+}
+
+double now(void) {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+void invalidate_frame(void) {
+	frame_valid = false;
+}
+
+void draw_action_text(const char* text) {
+	backend.erase_line(0, 2);
+	int x = board_win.x + (board_win.width - strlen(text)) / 4;
+	backend.print(2, x, "%s", text);
+}
+
+// Both boards share the action text line, so they are drawn together, each
+// over its own board and cut short before the opponent's.
+void draw_action_texts(const View* view) {
+	const char* text = view->action_text;
+	int x = board_win.x + (board_win.width - (int) strlen(text)) / 4;
+	int length = opponent_win.x - 1 - x;
+	backend.erase_line(0, 2);
+	backend.print(2, x, "%.*s", length > 0 ? length : 0, text);
+	text = view->opponent->action_text;
+	x = opponent_win.x + (opponent_win.width - (int) strlen(text)) / 4;
+	if (x < opponent_win.x)
+		x = opponent_win.x;
+	backend.print(2, x, "%s", text);
+}
+
+// Text over the board, like the best scores at the end of a game, for when
+// frames are no longer being drawn. Lines are cut to fit the board.
+void blank_board(void) {
+	for (int i = 0; i < board_win.height - 2; i++)
+		backend.print(board_win.y + 1 + i, board_win.x + 1, "%*s", board_win.width - 2, "");
+}
+
+void print_board_line(int line, const char* fmt, ...) {
+	if (line >= board_win.height - 2)
+		return;
+	char buffer[256];
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(buffer, sizeof(buffer), fmt, args);
+	va_end(args);
+	backend.print(board_win.y + 1 + line, board_win.x + 1, "%.*s", board_win.width - 2, buffer);
+}
+
+// draws action text now, for when frames are no longer being drawn
+void print_action_text(const char* fmt, ...) {
+	char buffer[512];
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(buffer, sizeof(buffer), fmt, args);
+	va_end(args);
+	draw_action_text(buffer);
+	backend.full_update();
+}
+
+void set_action_text(const char* fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(action_text, sizeof(action_text), fmt, args);
+	va_end(args);
+	action_text_count++;
+}
+
+void get_game_view(View* view) {
+	view->board = board;
+	view->hold_piece = game.hold_piece;
+	for (int i = 0; i < config.next_piece_queue_size; i++)
+		view_next_pieces[i] = CitrusGame_get_next_piece(&game, i);
+	view->next_pieces = view_next_pieces;
+	view->score = game.score;
+	view->level = game.level;
+	view->lines = game.lines;
+	view->pieces = pieces;
+	view->ticks = ticks;
+	view->attack = attack;
+	view->action_text = action_text;
+	view->action_text_count = action_text_count;
+	view->opponent = opponent_view;
+}
+
+void draw_view(const View* view) {
+	bool changed = !frame_valid;
+	if (!frame_valid) {
+		backend.erase_window(board_win);
+		backend.erase_window(hold_win);
+		backend.erase_window(next_piece_win);
+		if (view->opponent != NULL)
+			backend.erase_window(opponent_win);
+		for (int i = 0; i < view_rows * view_columns; i++)
+			drawn_board[i] = -1;
+		for (int i = 0; i < STATS_LINE + N_PHASES; i++)
+			drawn_hud[i][0] = '\0';
+	}
+	if (view->opponent != NULL) {
+		if (!frame_valid || view->action_text_count != drawn_action_text_count || view->opponent->action_text_count != drawn_opponent_action_text_count) {
+			draw_action_texts(view);
+			drawn_action_text_count = view->action_text_count;
+			drawn_opponent_action_text_count = view->opponent->action_text_count;
+			changed = true;
+		}
+	} else if (!frame_valid || view->action_text_count != drawn_action_text_count) {
+		draw_action_text(view->action_text);
+		drawn_action_text_count = view->action_text_count;
+		changed = true;
+	}
+	if (update_board(view) || !frame_valid) {
+		backend.draw_box(board_win);
+		backend.update(board_win);
+		changed = true;
+	}
+	if (show_minimap && (!frame_valid || view->pieces != drawn_minimap_pieces)) {
+		update_minimap(view);
+		changed = true;
+	}
+	if (!frame_valid || view->hold_piece != drawn_hold) {
+		if (frame_valid)
+			backend.erase_window(hold_win);
+		update_hold(view);
+		changed = true;
+	}
+	if (!frame_valid || next_pieces_changed(view)) {
+		if (frame_valid)
+			backend.erase_window(next_piece_win);
+		update_next_pieces(view);
+		changed = true;
+	}
+	changed |= update_hud_line(0, "Score: %i", view->score);
+	changed |= update_hud_line(1, "Level: %i", view->level);
+	changed |= update_hud_line(2, "Lines: %i", view->lines);
+	changed |= update_hud_line(3, "  PPS: %.2f", view->ticks > 0 ? ((float)view->pieces)/((float)view->ticks/tick_rate) : 0);
+	if (view->opponent != NULL) {
+		const View* opponent = view->opponent;
+		changed |= update_opponent(opponent);
+		changed |= update_hud_line(HUD_LINES, "Bot score: %i", opponent->score);
+		changed |= update_hud_line(HUD_LINES + 1, "    Lines: %i", opponent->lines);
+		changed |= update_hud_line(HUD_LINES + 2, "      PPS: %.2f", opponent->ticks > 0 ? ((float)opponent->pieces)/((float)opponent->ticks/tick_rate) : 0);
+		changed |= update_hud_line(HUD_LINES + 3, "     Sent: %i", opponent->attack);
+	}
+	if (show_stats && game_hooks.draw_stats != NULL)
+		changed |= game_hooks.draw_stats(STATS_LINE);
+	frame_valid = true;
+	if (changed) {
+		double start = now();
+		backend.full_update();
+		if (game_hooks.flushed != NULL)
+			game_hooks.flushed(start, now());
+	}
+}
+
+void update(void) {
+	View view;
+	if (game_hooks.get_view != NULL)
+		game_hooks.get_view(&view);
+	else
+		get_game_view(&view);
+	draw_view(&view);
+}
+
+// how many lines of garbage a piece sends
+int clear_attack(int n_lines_cleared, int combo, bool b2b, bool all_clear, bool spin) {
+	int attack = spin ? n_lines_cleared * 2 : attack_table[n_lines_cleared];
+	if (attack > 0 && b2b)
+		attack++;
+	if (combo > 0)
+		attack += combo_table[combo < 12 ? combo : 11];
+	if (all_clear)
+		attack += 10;
+	return attack;
+}
+
+void action_text_callback(void* data, int n_lines_cleared, int combo, bool b2b, bool all_clear, bool spin, bool mini_spin) {
+	pieces++;
+	attack += clear_attack(n_lines_cleared, combo, b2b, all_clear, spin);
+	(void) data;
+	if (!show_action_text || (n_lines_cleared == 0 && !spin && !mini_spin)) {
+		return;
+	}
+	const char* name = clear_names[n_lines_cleared];
+	char combo_text[512] = "";
+	if (combo > 0) {
+		snprintf(combo_text, sizeof(combo_text), " Combo %i", combo);
+	}
+	set_action_text("%s%s%s%s%s", all_clear ? "All Clear " : "", b2b ? "B2B " : "", spin ? "T Spin " : mini_spin ? "Mini T Spin " : "", name, combo_text);
+}
+
+void init_citrus(unsigned int seed) {
+	config.action_text = action_text_callback;
+	if (config.randomizer == CitrusBagRandomizer_randomizer) {
+		randomizer = malloc(sizeof(CitrusBagRandomizer));
+		CitrusBagRandomizer_init(randomizer, seed);
+	} else {
+		randomizer = malloc(sizeof(CitrusClassicRandomizer));
+		CitrusClassicRandomizer_init(randomizer, seed);
+	}
+	board = malloc(sizeof(CitrusCell) * config.full_height * config.width);
+	next_piece_queue = malloc(sizeof(CitrusPiece*) * config.next_piece_queue_size);
+	view_next_pieces = malloc(sizeof(CitrusPiece*) * config.next_piece_queue_size);
+	frame_valid = false;
+	CitrusGame_init(&game, board, next_piece_queue, config, randomizer, NULL);
+	pieces = 0;
+	ticks = 0;
+	attack = 0;
+}
+
+// for keys that come from outside, like the network or a replay file
+bool valid_key(int key) {
+	switch (key) {
+		case CITRUS_KEY_LEFT:
+		case CITRUS_KEY_RIGHT:
+		case CITRUS_KEY_SOFT_DROP:
+		case CITRUS_KEY_HARD_DROP:
+		case CITRUS_KEY_CLOCKWISE:
+		case CITRUS_KEY_ANTICLOCKWISE:
+		case CITRUS_KEY_180:
+		case CITRUS_KEY_HOLD:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// for board sizes that come from outside, with the same minimums as the
+// options, and a limit so that they can't ask for huge allocations
+bool valid_board_size(long long width, long long full_height, long long next_piece_queue_size) {
+	return width >= 4 && full_height >= 3 && next_piece_queue_size >= 0
+		&& width <= MAX_BOARD_CELLS && full_height <= MAX_BOARD_CELLS
+		&& width * full_height <= MAX_BOARD_CELLS
+		&& next_piece_queue_size <= MAX_QUEUE_SIZE;
+}
+
+// all key presses from the player go through these, so that they can be
+// recorded
+void game_key_down(CitrusKey key) {
+	if ((int) key < 0)
+		return;
+	if (game_hooks.send_key != NULL && game_hooks.send_key(key, false))
+		return;
+	CitrusGame_key_down(&game, key);
+}
+
+void game_key_up(CitrusKey key) {
+	if ((int) key < 0)
+		return;
+	if (game_hooks.send_key != NULL && game_hooks.send_key(key, true))
+		return;
+	CitrusGame_key_up(&game, key);
+}
+
+void free_citrus(void) {
+	free(board);
+	free(next_piece_queue);
+	free(randomizer);
+	free(view_next_pieces);
+}
+
+void resize(void) {
+	int width, height;
+	backend.get_size(&width, &height);
+	view_rows = height - 8;
+	if (view_rows < 4)
+		view_rows = 4;
+	if (view_rows > config.full_height)
+		view_rows = config.full_height;
+	minimap_scale = (config.full_height + view_rows - 1) / view_rows;
+	minimap_rows = (config.full_height + minimap_scale - 1) / minimap_scale;
+	minimap_columns = (config.width + minimap_scale - 1) / minimap_scale;
+	minimap_win.width = minimap_columns * 2 + 2;
+	minimap_win.height = minimap_rows + 2;
+	// leave room for the hold and next piece windows, the minimap and the
+	// stats overlay
+	int left = 12 + (show_minimap ? minimap_win.width + 2 : 0);
+	int right = 12 + (show_stats ? 40 : 0);
+	// and for the opponent's board and HUD, which is as big as the player's
+	int boards = 1;
+	if (opponent_view != NULL) {
+		boards = 2;
+		right += 18;
+	}
+	view_columns = (width - left - right - 2 * boards) / (2 * boards);
+	if (view_columns < 4)
+		view_columns = 4;
+	if (view_columns > config.width)
+		view_columns = config.width;
+	board_win.width = view_columns * 2 + 2;
+	board_win.height = view_rows + 2;
+	board_win.x = (width - board_win.width * boards - left - right) / 2 + left;
+	if (board_win.x < left)
+		board_win.x = left;
+	board_win.y = 4;
+	hold_win.width = 10;
+	hold_win.height = 6;
+	hold_win.x = board_win.x - hold_win.width - 2;
+	hold_win.y = board_win.y;
+	next_piece_win.width = 10;
+	next_piece_win.height = config.next_piece_queue_size * 4 + 2;
+	next_piece_win.x = board_win.x + board_win.width;
+	next_piece_win.y = board_win.y;
+	minimap_win.x = hold_win.x - minimap_win.width - 2;
+	minimap_win.y = board_win.y;
+	opponent_win.width = board_win.width;
+	opponent_win.height = board_win.height;
+	opponent_win.x = next_piece_win.x + next_piece_win.width + 2;
+	opponent_win.y = board_win.y;
+	stats_x = next_piece_win.x + next_piece_win.width + 2;
+	if (opponent_view != NULL)
+		stats_x = opponent_win.x + opponent_win.width + 18;
+	frame_valid = false;
+}
+
+// the config has to be set up before this, as it decides the size of the
+// board that is drawn
+void init_windows(void) {
+	free(drawn_board);
+	free(drawn_next_pieces);
+	free(seen_board);
+	free(empty_row);
+	free(drawn_opponent);
+	init_piece_table();
+	drawn_board = malloc(sizeof(int) * config.full_height * config.width);
+	drawn_next_pieces = malloc(sizeof(CitrusPiece*) * config.next_piece_queue_size);
+	seen_board = malloc(sizeof(CitrusCell) * config.full_height * config.width);
+	empty_row = malloc(sizeof(CitrusCell) * config.width);
+	drawn_opponent = malloc(sizeof(int) * config.full_height * config.width);
+	for (int x = 0; x < config.width; x++)
+		empty_row[x] = cells_by_color[0];
+	// big boards are scrolled, rather than making the window huge
+	int target_columns = config.width < MAX_TARGET_COLUMNS ? config.width : MAX_TARGET_COLUMNS;
+	int target_rows = config.full_height < MAX_TARGET_ROWS ? config.full_height : MAX_TARGET_ROWS;
+	int boards = opponent_view != NULL ? 2 : 1;
+	backend.set_target_size(target_columns * 2 * boards + 28 + (boards - 1) * 20, target_rows + 8);
+	resize();
+	backend.init_window(&hold_win);
+	backend.init_window(&board_win);
+	backend.init_window(&next_piece_win);
+	if (show_minimap)
+		backend.init_window(&minimap_win);
+	if (opponent_view != NULL)
+		backend.init_window(&opponent_win);
+	frame_valid = false;
+}
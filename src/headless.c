@@ -0,0 +1,108 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <time.h>
+#include "backend.h"
+
+// A backend that draws nothing and never produces input, used for running
+// the game without a terminal or display (benchmarks, replays). get_key
+// just waits out its timeout.
+
+int headless_width = 80;
+int headless_height = 50;
+
+void headless_init(void) {
+}
+
+void headless_exit(void) {
+}
+
+KeyType headless_get_key(double timeout, int* key, double* time) {
+	(void) key; (void) time;
+	struct timespec t = {timeout, (timeout - (long) timeout) * 1e9};
+	nanosleep(&t, NULL);
+	return KEYTYPE_NONE;
+}
+
+void headless_init_window(Window* window) {
+	window->backend_data = NULL;
+}
+
+void headless_resize_window(Window* window) {
+	(void) window;
+}
+
+void headless_full_update(void) {
+}
+
+void headless_update(Window window) {
+	(void) window;
+}
+
+void headless_print(int y, int x, const char* format, ...) {
+	(void) y; (void) x; (void) format;
+}
+
+void headless_erase_window(Window window) {
+	(void) window;
+}
+
+void headless_erase_line(int x, int y) {
+	(void) x; (void) y;
+}
+
+void headless_clear_screen(void) {
+}
+
+void headless_draw_cell(Window window, int x, int y, int color) {
+	(void) window; (void) x; (void) y; (void) color;
+}
+
+void headless_draw_box(Window window) {
+	(void) window;
+}
+
+void headless_get_size(int* width, int* height) {
+	*width = headless_width;
+	*height = headless_height;
+}
+
+void headless_set_target_size(int width, int height) {
+	headless_width = width;
+	headless_height = height;
+}
+
+Backend headless_backend = {
+	.init = headless_init,
+	.exit = headless_exit,
+	.get_key = headless_get_key,
+	.init_window = headless_init_window,
+	.resize_window = headless_resize_window,
+	.full_update = headless_full_update,
+	.update = headless_update,
+	.print = headless_print,
+	.erase_window = headless_erase_window,
+	.erase_line = headless_erase_line,
+	.clear_screen = headless_clear_screen,
+	.draw_cell = headless_draw_cell,
+	.draw_box = headless_draw_box,
+	.get_size = headless_get_size,
+	.set_target_size = headless_set_target_size,
+};
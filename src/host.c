@@ -0,0 +1,610 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+#include "ansi.h"
+#include "game.h"
+#include "host.h"
+#include "leaderboard.h"
+#include "net.h"
+
+// Hosts games for plain terminals that connect with telnet, or anything
+// else that passes raw keys through. Every session has its own game and its
+// own copy of its terminal's screen, and they are all run and drawn from one
+// event loop, so a session costs a few tens of kilobytes rather than a
+// process. The terminal size comes from telnet's NAWS option, or else from
+// asking the terminal where the cursor ends up after moving it to the far
+// corner. Sessions are drawn by draw_view, like a local game, through a
+// backend that puts them on screens of the ansi backend's kind, one per
+// session. So only the cells that changed are sent, and frames are skipped
+// while a session has a backlog.
+
+#define MAX_EVENTS 256
+#define MAX_OUTPUT (1 << 20)
+#define MAX_BACKLOG 4096
+#define MAX_CATCH_UP_TICKS 4
+#define MAX_TERMINAL_SIZE 500
+#define STATS_INTERVAL 10.0
+#define LEADERBOARD_ROWS 5
+// an escape sequence arrives in one go, so an ESC that is still on its own
+// after this long was the escape key
+#define ESCAPE_TIMEOUT 0.1
+
+// telnet commands and options
+#define IAC 255
+#define DONT 254
+#define DO 253
+#define WONT 252
+#define WILL 251
+#define SB 250
+#define SE 240
+#define OPTION_ECHO 1
+#define OPTION_SGA 3
+#define OPTION_TTYPE 24
+#define OPTION_NAWS 31
+#define TTYPE_IS 0
+#define TTYPE_SEND 1
+
+typedef enum {
+	TELNET_DATA,
+	TELNET_IAC,
+	TELNET_OPTION,
+	TELNET_SB,
+	TELNET_SB_IAC,
+} TelnetState;
+
+typedef struct Session Session;
+
+struct Session {
+	int fd;
+	Buffer input;
+	Buffer output;
+	bool writing;
+	bool removed;
+	Session* next;
+	Session* next_removed;
+	// what has been received of telnet commands and escape sequences
+	TelnetState telnet_state;
+	unsigned char telnet_command;
+	unsigned char sb[64];
+	int sb_length;
+	char escape[16];
+	int escape_length;
+	double escape_time;
+	// the terminal
+	bool naws;
+	AnsiScreen screen;
+	bool dirty;
+	// where the viewport was left, for boards taller than the terminal
+	int view_x;
+	int view_y;
+	// the game
+	CitrusGame game;
+	CitrusCell* board;
+	const CitrusPiece** next_piece_queue;
+	union {
+		CitrusBagRandomizer bag;
+		CitrusClassicRandomizer classic;
+	} randomizer;
+	CitrusCell* drawn_board;
+	int drawn_pieces;
+	int pieces;
+	int ticks;
+	bool playing;
+	// the leaderboard when the game ended
+	char player[LEADERBOARD_NAME_SIZE];
+	int rank;
+	int n_best;
+	LeaderboardRecord best[LEADERBOARD_ROWS];
+};
+
+Session* sessions = NULL;
+Session* removed_sessions = NULL;
+int host_epoll_fd;
+int host_listen_fd;
+int host_timer_fd;
+int n_sessions = 0;
+int n_connections = 0;
+bool host_leaderboard = false;
+const CitrusPiece** host_next_pieces;
+
+// Sessions are drawn onto their own screens, which draw_session sends.
+void host_get_size(int* width, int* height) {
+	*width = ansi_screen->width;
+	*height = ansi_screen->height;
+}
+
+void host_full_update(void) {
+}
+
+void host_set_target_size(int width, int height) {
+	(void) width; (void) height;
+}
+
+Backend host_backend = {
+	.init_window = ansi_init_window,
+	.resize_window = ansi_resize_window,
+	.full_update = host_full_update,
+	.update = ansi_update,
+	.print = ansi_print,
+	.erase_window = ansi_erase_window,
+	.erase_line = ansi_erase_line,
+	.clear_screen = ansi_clear_screen,
+	.draw_cell = ansi_draw_cell,
+	.draw_box = ansi_draw_box,
+	.get_size = host_get_size,
+	.set_target_size = host_set_target_size,
+};
+
+void host_action_text_callback(void* data, int n_lines_cleared, int combo, bool b2b, bool all_clear, bool spin, bool mini_spin) {
+	(void) n_lines_cleared; (void) combo; (void) b2b; (void) all_clear; (void) spin; (void) mini_spin;
+	Session* session = data;
+	session->pieces++;
+}
+
+void send_text(Session* session, const char* s, size_t size) {
+	buffer_append(&session->output, s, size);
+}
+
+void start_session_game(Session* session) {
+	CitrusGameConfig session_config = config;
+	session_config.action_text = host_action_text_callback;
+	unsigned int seed = rand();
+	if (config.randomizer == CitrusBagRandomizer_randomizer)
+		CitrusBagRandomizer_init(&session->randomizer.bag, seed);
+	else
+		CitrusClassicRandomizer_init(&session->randomizer.classic, seed);
+	CitrusGame_init(&session->game, session->board, session->next_piece_queue, session_config, &session->randomizer, session);
+	session->pieces = 0;
+	session->ticks = 0;
+	session->rank = 0;
+	session->n_best = 0;
+	session->playing = true;
+	session->dirty = true;
+}
+
+// Adds a game that has just ended to the leaderboard, and keeps the best
+// scores to show with it.
+void end_session_game(Session* session) {
+	session->playing = false;
+	session->dirty = true;
+	if (!host_leaderboard)
+		return;
+	LeaderboardRecord record = {0};
+	memcpy(record.player, session->player, LEADERBOARD_NAME_SIZE);
+	record.config_hash = leaderboard_config_hash();
+	record.score = session->game.score;
+	record.lines = session->game.lines;
+	record.pieces = session->pieces;
+	record.ticks = session->ticks;
+	record.pps = session->ticks > 0 ? (float) session->pieces / ((float) session->ticks / tick_rate) : 0;
+	record.time = time(NULL);
+	if (leaderboard_add(&record, NULL, &session->rank))
+		session->n_best = leaderboard_top(record.config_hash, LEADERBOARD_ROWS, session->best);
+}
+
+void resize_session(Session* session, int width, int height) {
+	if (width < 1 || height < 1 || width > MAX_TERMINAL_SIZE || height > MAX_TERMINAL_SIZE)
+		return;
+	if (width == session->screen.width && height == session->screen.height)
+		return;
+	ansi_screen_resize(&session->screen, width, height);
+	session->dirty = true;
+}
+
+void remove_session(Session* session) {
+	if (session->removed)
+		return;
+	epoll_ctl(host_epoll_fd, EPOLL_CTL_DEL, session->fd, NULL);
+	close(session->fd);
+	session->removed = true;
+	session->next_removed = removed_sessions;
+	removed_sessions = session;
+	n_sessions--;
+}
+
+void free_removed_sessions(void) {
+	while (removed_sessions != NULL) {
+		Session* session = removed_sessions;
+		removed_sessions = session->next_removed;
+		Session** p = &sessions;
+		while (*p != session)
+			p = &(*p)->next;
+		*p = session->next;
+		free(session->board);
+		free(session->next_piece_queue);
+		free(session->drawn_board);
+		ansi_screen_free(&session->screen);
+		buffer_free(&session->input);
+		buffer_free(&session->output);
+		free(session);
+	}
+}
+
+void flush_session(Session* session) {
+	while (session->output.size > 0) {
+		ssize_t n = send(session->fd, session->output.data, session->output.size, MSG_NOSIGNAL);
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if (n <= 0) {
+			remove_session(session);
+			return;
+		}
+		buffer_consume(&session->output, n);
+	}
+	if (session->output.size > MAX_OUTPUT) {
+		remove_session(session);
+		return;
+	}
+	bool writing = session->output.size > 0;
+	if (writing != session->writing) {
+		struct epoll_event event = {.events = EPOLLIN | (writing ? EPOLLOUT : 0), .data.ptr = session};
+		epoll_ctl(host_epoll_fd, EPOLL_CTL_MOD, session->fd, &event);
+		session->writing = writing;
+	}
+}
+
+void quit_session(Session* session) {
+	const char reset[] = "\033[0m\033[2J\033[?25h\033[?1049l";
+	send_text(session, reset, sizeof(reset) - 1);
+	flush_session(session);
+	remove_session(session);
+}
+
+void press_key(Session* session, CitrusKey key) {
+	if (!session->playing)
+		return;
+	CitrusGame_key_down(&session->game, key);
+	CitrusGame_key_up(&session->game, key);
+	if (!CitrusGame_is_alive(&session->game))
+		end_session_game(session);
+	session->dirty = true;
+}
+
+void handle_session_key(Session* session, int c) {
+	switch (c) {
+		case K_LEFT: press_key(session, CITRUS_KEY_LEFT); break;
+		case K_RIGHT: press_key(session, CITRUS_KEY_RIGHT); break;
+		case K_DOWN: press_key(session, CITRUS_KEY_SOFT_DROP); break;
+		case ' ': press_key(session, CITRUS_KEY_HARD_DROP); break;
+		case 'z': press_key(session, CITRUS_KEY_ANTICLOCKWISE); break;
+		case 'x': case K_UP: press_key(session, CITRUS_KEY_CLOCKWISE); break;
+		case 'c': press_key(session, CITRUS_KEY_HOLD); break;
+		case 'a': press_key(session, CITRUS_KEY_180); break;
+		case 'r':
+			if (!session->playing)
+				start_session_game(session);
+			break;
+		case 'q': case 3: case 4:
+			quit_session(session);
+			break;
+	}
+}
+
+void handle_subnegotiation(Session* session) {
+	const unsigned char* sb = session->sb;
+	if (session->sb_length == 5 && sb[0] == OPTION_NAWS) {
+		session->naws = true;
+		resize_session(session, sb[1] << 8 | sb[2], sb[3] << 8 | sb[4]);
+	} else if (session->sb_length > 2 && sb[0] == OPTION_TTYPE && sb[1] == TTYPE_IS) {
+		char name[64];
+		int length = session->sb_length - 2;
+		memcpy(name, sb + 2, length);
+		name[length] = '\0';
+		ansi_screen_set_colors(&session->screen, false, strstr(name, "256") != NULL);
+		ansi_screen_clear(&session->screen);
+		session->dirty = true;
+	}
+}
+
+void handle_escape(Session* session) {
+	int length = session->escape_length;
+	// there is always room for this, for sscanf
+	session->escape[length] = '\0';
+	const char* e = session->escape;
+	char final = e[length - 1];
+	if (length == 3 && (e[1] == '[' || e[1] == 'O')) {
+		switch (final) {
+			case 'A': handle_session_key(session, K_UP); break;
+			case 'B': handle_session_key(session, K_DOWN); break;
+			case 'C': handle_session_key(session, K_RIGHT); break;
+			case 'D': handle_session_key(session, K_LEFT); break;
+		}
+	} else if (final == 'R' && e[1] == '[' && !session->naws) {
+		// the reply to asking where the cursor is
+		int rows, columns;
+		if (sscanf(e + 2, "%i;%iR", &rows, &columns) == 2)
+			resize_session(session, columns, rows);
+	}
+}
+
+// Handles a byte of terminal input, which can be part of a telnet command or
+// an escape sequence.
+void handle_input_byte(Session* session, unsigned char c) {
+	switch (session->telnet_state) {
+		case TELNET_DATA:
+			if (c == IAC) {
+				session->telnet_state = TELNET_IAC;
+				return;
+			}
+			break;
+		case TELNET_IAC:
+			if (c == WILL || c == WONT || c == DO || c == DONT) {
+				session->telnet_state = TELNET_OPTION;
+				session->telnet_command = c;
+			} else if (c == SB) {
+				session->telnet_state = TELNET_SB;
+				session->sb_length = 0;
+			} else {
+				session->telnet_state = TELNET_DATA;
+			}
+			// IAC IAC is a 255 byte, which isn't a key anyway
+			return;
+		case TELNET_OPTION:
+			// the terminal type can only be asked for once the terminal
+			// has agreed to send it
+			if (session->telnet_command == WILL && c == OPTION_TTYPE) {
+				const unsigned char send[] = {IAC, SB, OPTION_TTYPE, TTYPE_SEND, IAC, SE};
+				send_text(session, (const char*) send, sizeof(send));
+			}
+			session->telnet_state = TELNET_DATA;
+			return;
+		case TELNET_SB:
+			if (c == IAC)
+				session->telnet_state = TELNET_SB_IAC;
+			else if (session->sb_length < (int) sizeof(session->sb))
+				session->sb[session->sb_length++] = c;
+			return;
+		case TELNET_SB_IAC:
+			if (c == SE) {
+				handle_subnegotiation(session);
+				session->telnet_state = TELNET_DATA;
+			} else {
+				if (session->sb_length < (int) sizeof(session->sb))
+					session->sb[session->sb_length++] = c;
+				session->telnet_state = TELNET_SB;
+			}
+			return;
+	}
+	if (session->escape_length == 1 && c != '[' && c != 'O') {
+		// the ESC was the escape key, so this is a key of its own
+		session->escape_length = 0;
+		handle_session_key(session, c);
+	} else if (session->escape_length > 0) {
+		session->escape[session->escape_length++] = c;
+		bool done = session->escape_length > 2 && c >= 0x40 && c <= 0x7e;
+		if (done || session->escape_length == (int) sizeof(session->escape) - 1) {
+			handle_escape(session);
+			session->escape_length = 0;
+		}
+	} else if (c == '\033') {
+		session->escape[session->escape_length++] = c;
+		session->escape_time = now();
+	} else {
+		handle_session_key(session, c);
+	}
+}
+
+void read_session_input(Session* session) {
+	if (session->escape_length == 1 && now() - session->escape_time > ESCAPE_TIMEOUT)
+		session->escape_length = 0;
+	while (true) {
+		unsigned char buffer[4096];
+		ssize_t n = recv(session->fd, buffer, sizeof(buffer), 0);
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if (n <= 0) {
+			remove_session(session);
+			return;
+		}
+		for (ssize_t i = 0; i < n && !session->removed; i++)
+			handle_input_byte(session, buffer[i]);
+		if (session->removed)
+			return;
+	}
+}
+
+void accept_sessions(void) {
+	while (true) {
+		int fd = accept(host_listen_fd, NULL, NULL);
+		if (fd < 0)
+			return;
+		set_nonblocking(fd);
+		int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+		Session* session = calloc(1, sizeof(Session));
+		session->fd = fd;
+		int size = config.full_height * config.width;
+		session->board = malloc(sizeof(CitrusCell) * size);
+		session->next_piece_queue = malloc(sizeof(CitrusPiece*) * config.next_piece_queue_size);
+		session->drawn_board = malloc(sizeof(CitrusCell) * size);
+		// telnet doesn't say how text is encoded, so boxes are plain ASCII
+		ansi_screen_init(&session->screen, false, false, false);
+		snprintf(session->player, sizeof(session->player), "guest%i", ++n_connections);
+		resize_session(session, 80, 24);
+		start_session_game(session);
+		// character at a time with no local echo, then the terminal's
+		// size and type
+		const unsigned char negotiation[] = {
+			IAC, WILL, OPTION_ECHO, IAC, WILL, OPTION_SGA, IAC, DO, OPTION_SGA,
+			IAC, DO, OPTION_NAWS, IAC, DO, OPTION_TTYPE,
+		};
+		send_text(session, (const char*) negotiation, sizeof(negotiation));
+		const char setup[] = "\033[?1049h\033[?25l\033[999;999H\033[6n";
+		send_text(session, setup, sizeof(setup) - 1);
+		session->next = sessions;
+		sessions = session;
+		struct epoll_event event = {.events = EPOLLIN, .data.ptr = session};
+		epoll_ctl(host_epoll_fd, EPOLL_CTL_ADD, fd, &event);
+		n_sessions++;
+		flush_session(session);
+	}
+}
+
+void get_session_view(Session* session, View* view) {
+	for (int i = 0; i < config.next_piece_queue_size; i++)
+		host_next_pieces[i] = CitrusGame_get_next_piece(&session->game, i);
+	*view = (View) {
+		.board = session->board,
+		.hold_piece = session->game.hold_piece,
+		.next_pieces = host_next_pieces,
+		.score = session->game.score,
+		.level = session->game.level,
+		.lines = session->game.lines,
+		.pieces = session->pieces,
+		.ticks = session->ticks,
+		.action_text = "",
+	};
+}
+
+// Redraws a session's screen if its game changed, and sends the cells that
+// differ from what its terminal shows. The layout is worked out again for
+// every frame, as each session's terminal has its own size.
+void draw_session(Session* session) {
+	size_t board_size = sizeof(CitrusCell) * config.width * config.full_height;
+	if (!session->dirty && session->pieces == session->drawn_pieces
+		&& memcmp(session->board, session->drawn_board, board_size) == 0)
+		return;
+	if (session->output.size > MAX_BACKLOG)
+		return;
+	memcpy(session->drawn_board, session->board, board_size);
+	session->drawn_pieces = session->pieces;
+	session->dirty = false;
+	ansi_screen = &session->screen;
+	view_x = session->view_x;
+	view_y = session->view_y;
+	resize();
+	ansi_clear_screen();
+	View view;
+	get_session_view(session, &view);
+	draw_view(&view);
+	session->view_x = view_x;
+	session->view_y = view_y;
+	if (session->playing) {
+		ansi_print(0, board_win.x, "txtris");
+	} else {
+		ansi_print(0, board_win.x, "Game over: r to play again, q to quit");
+		// the leaderboard goes over the board once the game is over
+		if (session->rank > 0) {
+			ansi_print(2, board_win.x, "You came #%i", session->rank);
+			blank_board();
+			print_board_line(0, "Best scores");
+			for (int i = 0; i < session->n_best; i++)
+				print_board_line(i + 2, "%2i %-8.8s %8i", i + 1, session->best[i].player, session->best[i].score);
+		}
+	}
+	ansi_screen_compose(&session->screen);
+	send_text(session, session->screen.frame, session->screen.frame_size);
+}
+
+void tick_sessions(int n_ticks) {
+	for (Session* session = sessions; session != NULL; session = session->next) {
+		if (session->removed)
+			continue;
+		for (int i = 0; i < n_ticks && session->playing; i++) {
+			CitrusGame_tick(&session->game);
+			session->ticks++;
+			if (!CitrusGame_is_alive(&session->game))
+				end_session_game(session);
+		}
+		draw_session(session);
+		if (session->output.size > 0)
+			flush_session(session);
+	}
+}
+
+int run_host(const char* address, bool use_leaderboard) {
+	host_leaderboard = use_leaderboard;
+	host_listen_fd = net_listen(address);
+	if (host_listen_fd < 0) {
+		perror(address);
+		return -1;
+	}
+	set_nonblocking(host_listen_fd);
+	srand(time(NULL));
+	backend = host_backend;
+	init_windows();
+	host_next_pieces = malloc(sizeof(CitrusPiece*) * config.next_piece_queue_size);
+	host_epoll_fd = epoll_create1(0);
+	host_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+	long tick_ns = 1000000000L / tick_rate;
+	// at one tick a second, the tick is a whole second, which tv_nsec can't hold
+	struct timespec tick_length = {tick_ns / 1000000000L, tick_ns % 1000000000L};
+	struct itimerspec interval = {tick_length, tick_length};
+	if (host_timer_fd < 0 || timerfd_settime(host_timer_fd, 0, &interval, NULL) < 0) {
+		perror("timerfd");
+		return -1;
+	}
+	struct epoll_event event = {.events = EPOLLIN, .data.ptr = &host_listen_fd};
+	epoll_ctl(host_epoll_fd, EPOLL_CTL_ADD, host_listen_fd, &event);
+	event.data.ptr = &host_timer_fd;
+	epoll_ctl(host_epoll_fd, EPOLL_CTL_ADD, host_timer_fd, &event);
+	fprintf(stderr, "hosting on %s\n", address);
+	double tick_time = 0;
+	int stats_ticks = 0;
+	double next_stats = now() + STATS_INTERVAL;
+	while (true) {
+		struct epoll_event events[MAX_EVENTS];
+		int n = epoll_wait(host_epoll_fd, events, MAX_EVENTS, -1);
+		if (n < 0 && errno != EINTR) {
+			perror("epoll_wait");
+			return -1;
+		}
+		for (int i = 0; i < n; i++) {
+			void* ptr = events[i].data.ptr;
+			if (ptr == &host_listen_fd) {
+				accept_sessions();
+			} else if (ptr == &host_timer_fd) {
+				uint64_t expirations = 0;
+				if (read(host_timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+					continue;
+				if (expirations > MAX_CATCH_UP_TICKS)
+					expirations = MAX_CATCH_UP_TICKS;
+				double start = now();
+				tick_sessions(expirations);
+				tick_time += now() - start;
+				stats_ticks += expirations;
+			} else {
+				Session* session = ptr;
+				if (!session->removed && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+					read_session_input(session);
+				if (!session->removed && session->output.size > 0)
+					flush_session(session);
+			}
+		}
+		free_removed_sessions();
+		if (now() >= next_stats) {
+			fprintf(stderr, "%i sessions, %.1f us per tick\n", n_sessions, stats_ticks > 0 ? tick_time / stats_ticks * 1e6 : 0);
+			tick_time = 0;
+			stats_ticks = 0;
+			next_stats += STATS_INTERVAL;
+		}
+	}
+}
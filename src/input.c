@@ -0,0 +1,162 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "game.h"
+#include "input.h"
+
+// Backends that support it are read on a separate thread, so that input is
+// timestamped when it arrives rather than when the main loop gets to it.
+// Events are passed to the main loop through a single producer, single
+// consumer ring buffer.
+
+#define INPUT_RING_SIZE 256
+// how often the input thread checks whether it should stop, which is as
+// often as it wakes up when there is no input
+#define INPUT_POLL 0.25
+
+InputEvent input_ring[INPUT_RING_SIZE];
+atomic_uint input_head = 0;
+atomic_uint input_tail = 0;
+atomic_bool input_running = false;
+pthread_t input_thread;
+pthread_mutex_t input_wait_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t input_wait_cond;
+// whether the main thread holds the backend while it isn't waiting
+bool input_holds_backend = false;
+
+bool input_push(const InputEvent* event) {
+	unsigned int head = atomic_load_explicit(&input_head, memory_order_relaxed);
+	unsigned int tail = atomic_load_explicit(&input_tail, memory_order_acquire);
+	if (head - tail == INPUT_RING_SIZE)
+		return false;
+	input_ring[head % INPUT_RING_SIZE] = *event;
+	atomic_store_explicit(&input_head, head + 1, memory_order_release);
+	return true;
+}
+
+bool input_pop(InputEvent* event) {
+	unsigned int tail = atomic_load_explicit(&input_tail, memory_order_relaxed);
+	unsigned int head = atomic_load_explicit(&input_head, memory_order_acquire);
+	if (head == tail)
+		return false;
+	*event = input_ring[tail % INPUT_RING_SIZE];
+	atomic_store_explicit(&input_tail, tail + 1, memory_order_release);
+	return true;
+}
+
+void* input_thread_main(void* data) {
+	(void) data;
+	while (atomic_load(&input_running)) {
+		InputEvent event;
+		event.type = backend.get_key(INPUT_POLL, &event.key, &event.time);
+		if (event.type == KEYTYPE_NONE)
+			continue;
+		while (!input_push(&event)) {
+			// the main loop is far behind, wait for it to make room
+			struct timespec t = {0, 1000000};
+			nanosleep(&t, NULL);
+		}
+		pthread_mutex_lock(&input_wait_lock);
+		pthread_cond_signal(&input_wait_cond);
+		pthread_mutex_unlock(&input_wait_lock);
+	}
+	return NULL;
+}
+
+void input_start(void) {
+	if (!backend.threaded_input)
+		return;
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&input_wait_cond, &attr);
+	pthread_condattr_destroy(&attr);
+	// the main thread only lets go of the backend while it is waiting
+	backend.lock();
+	input_holds_backend = true;
+	atomic_store(&input_running, true);
+	pthread_create(&input_thread, NULL, input_thread_main, NULL);
+	// make sure signals such as SIGWINCH wake the input thread
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGWINCH);
+	pthread_sigmask(SIG_BLOCK, &signals, NULL);
+}
+
+void input_stop(void) {
+	if (!atomic_load(&input_running))
+		return;
+	atomic_store(&input_running, false);
+	input_release_backend();
+	pthread_join(input_thread, NULL);
+	pthread_cond_destroy(&input_wait_cond);
+}
+
+// Lets go of the backend for good, for when another thread draws. The main
+// thread then has to lock the backend itself to use it.
+void input_release_backend(void) {
+	if (!input_holds_backend)
+		return;
+	input_holds_backend = false;
+	backend.unlock();
+}
+
+void input_take_backend(void) {
+	if (!atomic_load(&input_running) || input_holds_backend)
+		return;
+	backend.lock();
+	input_holds_backend = true;
+}
+
+// Gets the next input event, waiting at most timeout seconds for one.
+bool input_get(double timeout, InputEvent* event) {
+	if (!atomic_load(&input_running)) {
+		event->type = backend.get_key(timeout, &event->key, &event->time);
+		return event->type != KEYTYPE_NONE;
+	}
+	if (input_pop(event))
+		return true;
+	if (timeout <= 0)
+		return false;
+	double deadline = now() + timeout;
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	t.tv_sec += (long) timeout;
+	t.tv_nsec += (timeout - (long) timeout) * 1e9;
+	if (t.tv_nsec >= 1000000000) {
+		t.tv_sec++;
+		t.tv_nsec -= 1000000000;
+	}
+	if (input_holds_backend)
+		backend.unlock();
+	pthread_mutex_lock(&input_wait_lock);
+	bool found = input_pop(event);
+	while (!found && now() < deadline) {
+		pthread_cond_timedwait(&input_wait_cond, &input_wait_lock, &t);
+		found = input_pop(event);
+	}
+	pthread_mutex_unlock(&input_wait_lock);
+	if (input_holds_backend)
+		backend.lock();
+	return found;
+}
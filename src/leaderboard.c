@@ -0,0 +1,503 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "game.h"
+#include "leaderboard.h"
+
+// The leaderboard is an append-only log of fixed-size records, with two
+// index files that list record numbers in order: one by config then score,
+// and one by player, then config, then score. All three are memory-mapped,
+// so a top-N or per-player query is a binary search and a copy.
+//
+// An index only covers the log up to its count. The records after that,
+// at most TAIL_SIZE of them, are the tail, which queries scan as well. Once
+// the tail is full it is sorted and merged into the index in one pass, so
+// adding a game doesn't move the whole index each time.
+//
+// A record is written before the log's count is increased, so a game that
+// was being added when a process died is either there or not. An index is
+// marked as updating while it is merged or sorted, and its count only
+// changes once it is in order again. An index that is still marked when it
+// is next locked, or that doesn't list each record exactly once when the
+// leaderboard is opened, is sorted again from the log.
+//
+// Replay paths have different lengths, so they go in a separate list that
+// records point into. The log is locked while it is used, so several
+// processes can share one leaderboard.
+
+#define LOG_MAGIC "TXLB"
+#define INDEX_MAGIC "TXIX"
+#define LEADERBOARD_VERSION 1
+#define INDEX_VERSION 2
+#define TAIL_SIZE 256
+#define MIN_MAP_SIZE (1 << 16)
+
+typedef struct {
+	char magic[4];
+	uint32_t version;
+	uint32_t record_size;
+	uint32_t reserved;
+	uint64_t count;
+	char padding[40];
+} LogHeader;
+
+typedef struct {
+	char magic[4];
+	uint32_t version;
+	uint64_t count;
+	// set while the ids are being moved, when they can't be trusted
+	uint32_t updating;
+	uint32_t reserved;
+} IndexHeader;
+
+typedef struct {
+	int fd;
+	char* data;
+	size_t size;
+} MappedFile;
+
+typedef int (*RecordCompare)(const LeaderboardRecord* a, const LeaderboardRecord* b);
+
+typedef struct {
+	MappedFile file;
+	RecordCompare compare;
+} Index;
+
+int compare_scores(const LeaderboardRecord* a, const LeaderboardRecord* b);
+int compare_players(const LeaderboardRecord* a, const LeaderboardRecord* b);
+
+MappedFile log_file = {-1, NULL, 0};
+Index score_index = {{-1, NULL, 0}, compare_scores};
+Index player_index = {{-1, NULL, 0}, compare_players};
+int replay_list_fd = -1;
+// for qsort, which can't pass the index to the comparison
+Index* sorting_index;
+
+// FNV-1a over everything that changes how a game plays, so that only games
+// with the same settings are ranked against each other
+uint32_t leaderboard_config_hash(void) {
+	int values[] = {
+		config.width, config.height, config.full_height, config.lock_delay, config.max_move_reset,
+		config.next_piece_queue_size, config.line_clear_delay, config.shadow, config.arr, config.das,
+		config.randomizer == CitrusBagRandomizer_randomizer ? 0 : 1, tick_rate,
+	};
+	double gravity = config.gravity;
+	unsigned char bytes[sizeof(values) + sizeof(gravity)];
+	memcpy(bytes, values, sizeof(values));
+	memcpy(bytes + sizeof(values), &gravity, sizeof(gravity));
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < sizeof(bytes); i++)
+		hash = (hash ^ bytes[i]) * 16777619u;
+	return hash;
+}
+
+int compare_scores(const LeaderboardRecord* a, const LeaderboardRecord* b) {
+	if (a->config_hash != b->config_hash)
+		return a->config_hash < b->config_hash ? -1 : 1;
+	if (a->score != b->score)
+		return a->score > b->score ? -1 : 1;
+	if (a->lines != b->lines)
+		return a->lines > b->lines ? -1 : 1;
+	if (a->ticks != b->ticks)
+		return a->ticks < b->ticks ? -1 : 1;
+	return 0;
+}
+
+int compare_players(const LeaderboardRecord* a, const LeaderboardRecord* b) {
+	int c = strncmp(a->player, b->player, LEADERBOARD_NAME_SIZE);
+	if (c != 0)
+		return c;
+	return compare_scores(a, b);
+}
+
+// Maps at least needed bytes of a file, growing the file if it is shorter.
+// Files grow in doubling steps so that appending doesn't remap every time.
+bool ensure_mapped(MappedFile* file, size_t needed) {
+	if (needed <= file->size)
+		return true;
+	struct stat st;
+	if (fstat(file->fd, &st) < 0)
+		return false;
+	size_t size = st.st_size;
+	if (size < needed) {
+		size = file->size * 2;
+		if (size < MIN_MAP_SIZE)
+			size = MIN_MAP_SIZE;
+		while (size < needed)
+			size *= 2;
+		if (ftruncate(file->fd, size) < 0)
+			return false;
+	}
+	void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file->fd, 0);
+	if (data == MAP_FAILED)
+		return false;
+	if (file->data != NULL)
+		munmap(file->data, file->size);
+	file->data = data;
+	file->size = size;
+	return true;
+}
+
+void unmap_file(MappedFile* file) {
+	if (file->data != NULL)
+		munmap(file->data, file->size);
+	if (file->fd >= 0)
+		close(file->fd);
+	file->fd = -1;
+	file->data = NULL;
+	file->size = 0;
+}
+
+LogHeader* log_header(void) {
+	return (LogHeader*) log_file.data;
+}
+
+LeaderboardRecord* log_records(void) {
+	return (LeaderboardRecord*) (log_file.data + sizeof(LogHeader));
+}
+
+IndexHeader* index_header(Index* index) {
+	return (IndexHeader*) index->file.data;
+}
+
+uint32_t* index_ids(Index* index) {
+	return (uint32_t*) (index->file.data + sizeof(IndexHeader));
+}
+
+// the first position in the first count ids of an index whose record
+// doesn't come before key
+size_t lower_bound(Index* index, size_t count, const LeaderboardRecord* key) {
+	const LeaderboardRecord* records = log_records();
+	const uint32_t* ids = index_ids(index);
+	size_t low = 0;
+	size_t high = count;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (index->compare(&records[ids[middle]], key) < 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return low;
+}
+
+// the first position in the first count ids of an index whose record comes
+// after key, so that records that tie stay in the order they were added
+size_t upper_bound(Index* index, size_t count, const LeaderboardRecord* key) {
+	const LeaderboardRecord* records = log_records();
+	const uint32_t* ids = index_ids(index);
+	size_t low = 0;
+	size_t high = count;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (index->compare(&records[ids[middle]], key) <= 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return low;
+}
+
+int compare_sorting_ids(const void* a, const void* b) {
+	uint32_t id_a = *(const uint32_t*) a;
+	uint32_t id_b = *(const uint32_t*) b;
+	const LeaderboardRecord* records = log_records();
+	int c = sorting_index->compare(&records[id_a], &records[id_b]);
+	if (c != 0)
+		return c;
+	return id_a < id_b ? -1 : id_a > id_b;
+}
+
+void sort_ids(Index* index, uint32_t* ids, size_t count) {
+	sorting_index = index;
+	qsort(ids, count, sizeof(uint32_t), compare_sorting_ids);
+}
+
+// Sorts the whole index again from the log.
+void rebuild_index(Index* index, uint64_t count) {
+	IndexHeader* header = index_header(index);
+	header->updating = 1;
+	uint32_t* ids = index_ids(index);
+	for (uint64_t i = 0; i < count; i++)
+		ids[i] = i;
+	sort_ids(index, ids, count);
+	memcpy(header->magic, INDEX_MAGIC, 4);
+	header->version = INDEX_VERSION;
+	header->count = count;
+	header->updating = 0;
+}
+
+// Merges the tail into the index. The tail is sorted on its own, then each
+// of its records is put in place from the back, moving the ids after it
+// once, so the whole merge moves the index only once.
+bool merge_tail(Index* index, uint64_t count) {
+	IndexHeader* header = index_header(index);
+	size_t n_tail = count - header->count;
+	uint32_t* tail = malloc(n_tail * sizeof(uint32_t));
+	if (tail == NULL)
+		return false;
+	for (size_t i = 0; i < n_tail; i++)
+		tail[i] = header->count + i;
+	sort_ids(index, tail, n_tail);
+	header->updating = 1;
+	uint32_t* ids = index_ids(index);
+	size_t end = header->count;
+	for (size_t i = n_tail; i-- > 0;) {
+		// the tail comes after everything in the index, so it goes after
+		// the records that it ties with
+		size_t position = upper_bound(index, end, &log_records()[tail[i]]);
+		memmove(ids + position + i + 1, ids + position, (end - position) * sizeof(uint32_t));
+		ids[position + i] = tail[i];
+		end = position;
+	}
+	free(tail);
+	header->count = count;
+	header->updating = 0;
+	return true;
+}
+
+// Brings an index up to date with the log, merging in the tail once it is
+// full, or sorting it from scratch if it doesn't belong to the log or was
+// left part way through being changed.
+bool sync_index(Index* index) {
+	uint64_t count = log_header()->count;
+	if (!ensure_mapped(&index->file, sizeof(IndexHeader) + (count + 1) * sizeof(uint32_t)))
+		return false;
+	IndexHeader* header = index_header(index);
+	if (memcmp(header->magic, INDEX_MAGIC, 4) != 0 || header->version != INDEX_VERSION || header->updating
+		|| header->count > count) {
+		rebuild_index(index, count);
+		return true;
+	}
+	if (count - header->count >= TAIL_SIZE)
+		return merge_tail(index, count);
+	return true;
+}
+
+// Checks that an index lists each record it covers exactly once. This only
+// reads the index, not the records, so it is cheap enough to do on every
+// open, and the updating mark already covers the order being left wrong.
+bool index_complete(Index* index) {
+	const IndexHeader* header = index_header(index);
+	const uint32_t* ids = index_ids(index);
+	uint64_t* seen = calloc(header->count / 64 + 1, sizeof(uint64_t));
+	if (seen == NULL)
+		return false;
+	bool complete = true;
+	for (uint64_t i = 0; i < header->count && complete; i++) {
+		uint32_t id = ids[i];
+		if (id >= header->count || (seen[id / 64] >> (id % 64) & 1))
+			complete = false;
+		else
+			seen[id / 64] |= (uint64_t) 1 << (id % 64);
+	}
+	free(seen);
+	return complete;
+}
+
+// Locks the leaderboard and makes sure that all of it is mapped and indexed,
+// in case another process has added to it.
+bool lock_leaderboard(void) {
+	if (flock(log_file.fd, LOCK_EX) < 0)
+		return false;
+	if (ensure_mapped(&log_file, sizeof(LogHeader) + log_header()->count * sizeof(LeaderboardRecord))
+		&& sync_index(&score_index) && sync_index(&player_index))
+		return true;
+	flock(log_file.fd, LOCK_UN);
+	return false;
+}
+
+void unlock_leaderboard(void) {
+	flock(log_file.fd, LOCK_UN);
+}
+
+bool open_index(Index* index, const char* path, const char* suffix) {
+	char index_path[4096];
+	snprintf(index_path, sizeof(index_path), "%s%s", path, suffix);
+	index->file.fd = open(index_path, O_RDWR | O_CREAT, 0644);
+	return index->file.fd >= 0;
+}
+
+bool leaderboard_open(const char* path) {
+	log_file.fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (log_file.fd < 0)
+		return false;
+	char replay_list_path[4096];
+	snprintf(replay_list_path, sizeof(replay_list_path), "%s.replays", path);
+	replay_list_fd = open(replay_list_path, O_RDWR | O_CREAT | O_APPEND, 0644);
+	if (replay_list_fd < 0 || !open_index(&score_index, path, ".scores") || !open_index(&player_index, path, ".players")
+		|| flock(log_file.fd, LOCK_EX) < 0) {
+		leaderboard_close();
+		return false;
+	}
+	bool valid = ensure_mapped(&log_file, sizeof(LogHeader));
+	if (valid) {
+		LogHeader* header = log_header();
+		if (header->magic[0] == '\0') {
+			memcpy(header->magic, LOG_MAGIC, 4);
+			header->version = LEADERBOARD_VERSION;
+			header->record_size = sizeof(LeaderboardRecord);
+			header->count = 0;
+		}
+		valid = memcmp(header->magic, LOG_MAGIC, 4) == 0 && header->version == LEADERBOARD_VERSION
+			&& header->record_size == sizeof(LeaderboardRecord);
+	}
+	unlock_leaderboard();
+	if (!valid || !lock_leaderboard()) {
+		leaderboard_close();
+		return false;
+	}
+	// in case an index was damaged some other way than being interrupted
+	if (!index_complete(&score_index))
+		rebuild_index(&score_index, log_header()->count);
+	if (!index_complete(&player_index))
+		rebuild_index(&player_index, log_header()->count);
+	unlock_leaderboard();
+	return true;
+}
+
+bool matches(const LeaderboardRecord* record, const LeaderboardRecord* key, bool same_player) {
+	return record->config_hash == key->config_hash
+		&& (!same_player || strncmp(record->player, key->player, LEADERBOARD_NAME_SIZE) == 0);
+}
+
+// Adds a finished game, and gives its rank among games with the same config.
+bool leaderboard_add(LeaderboardRecord* record, const char* replay_path, int* rank) {
+	if (!lock_leaderboard())
+		return false;
+	record->player[LEADERBOARD_NAME_SIZE - 1] = '\0';
+	record->replay_offset = NO_REPLAY;
+	if (replay_path != NULL) {
+		off_t offset = lseek(replay_list_fd, 0, SEEK_END);
+		size_t length = strlen(replay_path) + 1;
+		if (offset >= 0 && write(replay_list_fd, replay_path, length) == (ssize_t) length)
+			record->replay_offset = offset;
+	}
+	uint64_t count = log_header()->count;
+	if (!ensure_mapped(&log_file, sizeof(LogHeader) + (count + 1) * sizeof(LeaderboardRecord))) {
+		unlock_leaderboard();
+		return false;
+	}
+	const LeaderboardRecord* log = log_records();
+	log_records()[count] = *record;
+	log_header()->count = count + 1;
+	// the new game goes in the tail, and is merged in at a later add
+	if (rank != NULL) {
+		LeaderboardRecord best = {.config_hash = record->config_hash, .score = INT32_MAX, .lines = INT32_MAX, .ticks = INT32_MIN};
+		size_t indexed = index_header(&score_index)->count;
+		*rank = upper_bound(&score_index, indexed, record) - lower_bound(&score_index, indexed, &best) + 1;
+		for (uint64_t id = indexed; id < count; id++) {
+			if (log[id].config_hash == record->config_hash && compare_scores(&log[id], record) <= 0)
+				(*rank)++;
+		}
+	}
+	unlock_leaderboard();
+	return true;
+}
+
+// Copies up to n records that match key, in the order of an index, merging
+// the ones in the index with the best n in the tail.
+int find_matching(Index* index, const LeaderboardRecord* key, bool same_player, int n, LeaderboardRecord* records) {
+	const LeaderboardRecord* log = log_records();
+	const uint32_t* ids = index_ids(index);
+	uint64_t indexed = index_header(index)->count;
+	uint64_t count = log_header()->count;
+	uint32_t tail[TAIL_SIZE];
+	int n_tail = 0;
+	int keep = n < TAIL_SIZE ? n : TAIL_SIZE;
+	sorting_index = index;
+	for (uint64_t id = indexed; id < count; id++) {
+		if (!matches(&log[id], key, same_player))
+			continue;
+		// insertion into the best ones so far, since n is usually small
+		uint32_t new_id = id;
+		int i = n_tail < keep ? n_tail++ : keep;
+		while (i > 0 && compare_sorting_ids(&new_id, &tail[i - 1]) < 0) {
+			if (i < keep)
+				tail[i] = tail[i - 1];
+			i--;
+		}
+		if (i < keep)
+			tail[i] = new_id;
+	}
+	size_t position = lower_bound(index, indexed, key);
+	int found = 0;
+	int t = 0;
+	while (found < n) {
+		bool from_index = position < indexed && matches(&log[ids[position]], key, same_player);
+		if (!from_index && t == n_tail)
+			break;
+		if (from_index && t < n_tail && compare_sorting_ids(&tail[t], &ids[position]) < 0)
+			from_index = false;
+		records[found++] = from_index ? log[ids[position++]] : log[tail[t++]];
+	}
+	return found;
+}
+
+// the best n games with a config
+int leaderboard_top(uint32_t config_hash, int n, LeaderboardRecord* records) {
+	if (!lock_leaderboard())
+		return 0;
+	LeaderboardRecord key = {.config_hash = config_hash, .score = INT32_MAX, .lines = INT32_MAX, .ticks = INT32_MIN};
+	int found = find_matching(&score_index, &key, false, n, records);
+	unlock_leaderboard();
+	return found;
+}
+
+// a player's best n games with a config
+int leaderboard_player(const char* player, uint32_t config_hash, int n, LeaderboardRecord* records) {
+	if (!lock_leaderboard())
+		return 0;
+	LeaderboardRecord key = {.config_hash = config_hash, .score = INT32_MAX, .lines = INT32_MAX, .ticks = INT32_MIN};
+	strncpy(key.player, player, LEADERBOARD_NAME_SIZE - 1);
+	int found = find_matching(&player_index, &key, true, n, records);
+	unlock_leaderboard();
+	return found;
+}
+
+long leaderboard_count(void) {
+	return log_header()->count;
+}
+
+bool leaderboard_replay_path(const LeaderboardRecord* record, char* path, size_t size) {
+	if (record->replay_offset == NO_REPLAY || size == 0)
+		return false;
+	ssize_t n = pread(replay_list_fd, path, size - 1, record->replay_offset);
+	if (n <= 0)
+		return false;
+	path[n] = '\0';
+	return strlen(path) < (size_t) n;
+}
+
+void leaderboard_close(void) {
+	unmap_file(&log_file);
+	unmap_file(&score_index.file);
+	unmap_file(&player_index.file);
+	if (replay_list_fd >= 0)
+		close(replay_list_fd);
+	replay_list_fd = -1;
+}
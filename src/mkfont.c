@@ -0,0 +1,107 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_SFNT_NAMES_H
+#include FT_TRUETYPE_IDS_H
+#include <stdio.h>
+#include <stdlib.h>
+#include "font.h"
+
+// Rasterizes a font into the glyph atlas that the SDL3 backend draws text
+// with, and writes it out as C source. It is run by `make font`, so
+// txtris itself never loads or rasterizes a font unless given one with -F.
+// Each pixel is written as a hex digit of coverage, with '.' for nothing,
+// so the glyphs can be read in the generated source.
+
+int main(int argc, char** argv) {
+	if (argc != 2) {
+		fprintf(stderr, "usage: %s FONT\n", argv[0]);
+		return 1;
+	}
+	FT_Library library;
+	FT_Face face;
+	if (FT_Init_FreeType(&library) != 0 || FT_New_Face(library, argv[1], 0, &face) != 0) {
+		fprintf(stderr, "%s: can't load %s\n", argv[0], argv[1]);
+		return 1;
+	}
+	// the largest size whose advance and line height fit in a cell
+	int size = FONT_HEIGHT;
+	while (size > 1) {
+		FT_Set_Pixel_Sizes(face, 0, size);
+		FT_Load_Char(face, 'M', FT_LOAD_DEFAULT);
+		int advance = (face->glyph->advance.x + 63) >> 6;
+		int height = (face->size->metrics.ascender - face->size->metrics.descender + 63) >> 6;
+		if (advance <= FONT_WIDTH && height <= FONT_HEIGHT)
+			break;
+		size--;
+	}
+	int ascender = face->size->metrics.ascender >> 6;
+	int descender = face->size->metrics.descender >> 6;
+	int baseline = (FONT_HEIGHT - (ascender - descender)) / 2 + ascender;
+
+	printf("/* Generated by `make font` from %s at %ipx.\n", face->family_name, size);
+	// the font's own copyright notice goes along with its glyphs
+	for (FT_UInt i = 0; i < FT_Get_Sfnt_Name_Count(face); i++) {
+		FT_SfntName name;
+		if (FT_Get_Sfnt_Name(face, i, &name) != 0 || name.name_id != TT_NAME_ID_COPYRIGHT)
+			continue;
+		if (name.platform_id != TT_PLATFORM_MACINTOSH)
+			continue;
+		const char* line = (const char*) name.string;
+		const char* end = line + name.string_len;
+		while (line < end) {
+			int length = 0;
+			while (line + length < end && line[length] != '\n')
+				length++;
+			if (length > 0)
+				printf(" * %.*s\n", length, line);
+			line += length + 1;
+		}
+		break;
+	}
+	printf(" * Do not edit, change FONT and run `make font` again. */\n\n");
+	printf("#include \"font.h\"\n\n");
+	printf("const char font_glyphs[FONT_GLYPHS][FONT_HEIGHT][FONT_WIDTH + 1] = {\n");
+	for (int c = FONT_FIRST; c <= FONT_LAST; c++) {
+		FT_Load_Char(face, c, FT_LOAD_RENDER);
+		FT_GlyphSlot glyph = face->glyph;
+		FT_Bitmap* bitmap = &glyph->bitmap;
+		printf("\t// '%s%c'\n\t{\n", c == '\'' || c == '\\' ? "\\" : "", c);
+		for (int y = 0; y < FONT_HEIGHT; y++) {
+			char row[FONT_WIDTH + 1];
+			for (int x = 0; x < FONT_WIDTH; x++) {
+				int bx = x - glyph->bitmap_left;
+				int by = y - (baseline - glyph->bitmap_top);
+				int value = 0;
+				if (bx >= 0 && bx < (int) bitmap->width && by >= 0 && by < (int) bitmap->rows)
+					value = (bitmap->buffer[by * bitmap->pitch + bx] * 15 + 127) / 255;
+				row[x] = value == 0 ? '.' : "0123456789abcdef"[value];
+			}
+			row[FONT_WIDTH] = '\0';
+			printf("\t\t\"%s\",\n", row);
+		}
+		printf("\t},\n");
+	}
+	printf("};\n");
+	FT_Done_Face(face);
+	FT_Done_FreeType(library);
+	return 0;
+}
@@ -18,8 +18,12 @@
  */
 
 #include <ncurses.h>
+#include <pthread.h>
+#include <sys/select.h>
+#include <unistd.h>
 #include "backend.h"
 #include "citrus.h"
+#include "game.h"
 
 // color, rgb, default ncurses color, 8-bit color code
 const int ncurses_colors[7][6] = {
@@ -32,12 +36,15 @@ const int ncurses_colors[7][6] = {
 	{CITRUS_COLOR_Z, 188, 46, 61, COLOR_RED, 160},
 };
 
+pthread_mutex_t curses_lock = PTHREAD_MUTEX_INITIALIZER;
+
 void ncurses_init(void) {
 	initscr();
 	cbreak();
 	noecho();
 	use_default_colors();
 	keypad(stdscr, TRUE);
+	nodelay(stdscr, TRUE);
 	start_color();
 	init_pair(1, -1, COLOR_WHITE);
 	for (int i=0; i < 7; i++) {
@@ -63,9 +70,35 @@ void ncurses_exit(void) {
 	endwin();
 }
 
-KeyType ncurses_get_key(int ms_timeout, int* key) {
-	timeout(ms_timeout);
+void ncurses_lock(void) {
+	pthread_mutex_lock(&curses_lock);
+}
+
+void ncurses_unlock(void) {
+	pthread_mutex_unlock(&curses_lock);
+}
+
+// This runs on the input thread. getch only takes a timeout in whole
+// milliseconds, so wait for input with pselect instead and then read
+// whatever is there without blocking. Input is timestamped when it becomes
+// readable, before waiting for the main thread to finish drawing. Keys
+// that were already waiting are timestamped when this is called.
+KeyType ncurses_get_key(double timeout, int* key, double* time) {
+	*time = now();
+	ncurses_lock();
 	int ch = getch();
+	ncurses_unlock();
+	if (ch == ERR && timeout > 0) {
+		fd_set fds;
+		FD_ZERO(&fds);
+		FD_SET(STDIN_FILENO, &fds);
+		struct timespec t = {timeout, (timeout - (long) timeout) * 1e9};
+		pselect(STDIN_FILENO + 1, &fds, NULL, NULL, &t, NULL);
+		*time = now();
+		ncurses_lock();
+		ch = getch();
+		ncurses_unlock();
+	}
 	switch (ch) {
 		case KEY_LEFT: *key = K_LEFT; break;
 		case KEY_RIGHT: *key = K_RIGHT; break;
@@ -151,4 +184,7 @@ Backend ncurses_backend = {
 	.draw_box = ncurses_draw_box,
 	.get_size = ncurses_get_size,
 	.set_target_size = ncurses_set_target_size,
+	.threaded_input = true,
+	.lock = ncurses_lock,
+	.unlock = ncurses_unlock,
 };
@@ -0,0 +1,195 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "net.h"
+
+// Message lengths are sent in front of a message, but are only known once
+// it has been written, so space for a varint of this many bytes is reserved.
+#define LENGTH_BYTES 4
+
+void buffer_append(Buffer* buffer, const void* data, size_t size) {
+	if (buffer->size + size > buffer->capacity) {
+		size_t capacity = buffer->capacity == 0 ? 256 : buffer->capacity;
+		while (buffer->size + size > capacity)
+			capacity *= 2;
+		buffer->data = realloc(buffer->data, capacity);
+		buffer->capacity = capacity;
+	}
+	memcpy(buffer->data + buffer->size, data, size);
+	buffer->size += size;
+}
+
+void buffer_consume(Buffer* buffer, size_t size) {
+	memmove(buffer->data, buffer->data + size, buffer->size - size);
+	buffer->size -= size;
+}
+
+void buffer_free(Buffer* buffer) {
+	free(buffer->data);
+	buffer->data = NULL;
+	buffer->size = 0;
+	buffer->capacity = 0;
+}
+
+void put_byte(Buffer* buffer, int byte) {
+	unsigned char c = byte;
+	buffer_append(buffer, &c, 1);
+}
+
+void put_varint(Buffer* buffer, uint64_t value) {
+	while (value >= 0x80) {
+		put_byte(buffer, (value & 0x7f) | 0x80);
+		value >>= 7;
+	}
+	put_byte(buffer, value);
+}
+
+size_t message_begin(Buffer* buffer, MessageType type) {
+	unsigned char header[1 + LENGTH_BYTES] = {type};
+	buffer_append(buffer, header, sizeof(header));
+	return buffer->size;
+}
+
+void message_end(Buffer* buffer, size_t start) {
+	size_t length = buffer->size - start;
+	unsigned char* p = buffer->data + start - LENGTH_BYTES;
+	// a padded varint, so that its size doesn't depend on the length
+	for (int i = 0; i < LENGTH_BYTES; i++) {
+		p[i] = (length & 0x7f) | (i < LENGTH_BYTES - 1 ? 0x80 : 0);
+		length >>= 7;
+	}
+}
+
+// Gets the next complete message after offset, if there is one.
+bool next_message(Buffer* buffer, size_t* offset, Message* message) {
+	const unsigned char* p = buffer->data + *offset;
+	const unsigned char* end = buffer->data + buffer->size;
+	if (p == end)
+		return false;
+	message->type = *p++;
+	uint64_t length = 0;
+	for (int shift = 0;; shift += 7) {
+		if (p == end || shift >= 28)
+			return false;
+		length |= (uint64_t) (*p & 0x7f) << shift;
+		if ((*p++ & 0x80) == 0)
+			break;
+	}
+	if ((uint64_t) (end - p) < length)
+		return false;
+	message->data = p;
+	message->end = p + length;
+	*offset = message->end - buffer->data;
+	return true;
+}
+
+int get_byte(Message* message) {
+	if (message->data == message->end)
+		return -1;
+	return *message->data++;
+}
+
+uint64_t get_varint(Message* message) {
+	uint64_t value = 0;
+	for (int shift = 0; shift < 64 && message->data != message->end; shift += 7) {
+		int c = *message->data++;
+		value |= (uint64_t) (c & 0x7f) << shift;
+		if ((c & 0x80) == 0)
+			break;
+	}
+	return value;
+}
+
+void set_nonblocking(int fd) {
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+// Addresses are either unix:PATH for a unix socket or HOST:PORT for TCP.
+// Returns a socket, or -1 on failure.
+int open_socket(const char* address, bool server) {
+	if (strncmp(address, "unix:", 5) == 0) {
+		struct sockaddr_un addr = {.sun_family = AF_UNIX};
+		if (strlen(address + 5) >= sizeof(addr.sun_path))
+			return -1;
+		strcpy(addr.sun_path, address + 5);
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+			return -1;
+		if (server) {
+			unlink(addr.sun_path);
+			if (bind(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0) {
+				close(fd);
+				return -1;
+			}
+		} else if (connect(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+			close(fd);
+			return -1;
+		}
+		return fd;
+	}
+	char host[256];
+	const char* colon = strrchr(address, ':');
+	if (colon == NULL || (size_t) (colon - address) >= sizeof(host))
+		return -1;
+	memcpy(host, address, colon - address);
+	host[colon - address] = '\0';
+	struct addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM};
+	if (server)
+		hints.ai_flags = AI_PASSIVE;
+	struct addrinfo* info;
+	if (getaddrinfo(host[0] == '\0' ? NULL : host, colon + 1, &hints, &info) != 0)
+		return -1;
+	int fd = -1;
+	for (struct addrinfo* i = info; i != NULL; i = i->ai_next) {
+		fd = socket(i->ai_family, i->ai_socktype, i->ai_protocol);
+		if (fd < 0)
+			continue;
+		int one = 1;
+		if (server) {
+			setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+			if (bind(fd, i->ai_addr, i->ai_addrlen) == 0 && listen(fd, SOMAXCONN) == 0)
+				break;
+		} else if (connect(fd, i->ai_addr, i->ai_addrlen) == 0) {
+			// key presses are tiny and need to arrive straight away
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+			break;
+		}
+		close(fd);
+		fd = -1;
+	}
+	freeaddrinfo(info);
+	return fd;
+}
+
+int net_listen(const char* address) {
+	return open_socket(address, true);
+}
+
+int net_connect(const char* address) {
+	return open_socket(address, false);
+}
@@ -0,0 +1,85 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "bitboard.h"
+#include "game.h"
+
+#define MAX_DEPTH 16
+
+const char* program_name;
+int depth = 4;
+unsigned int seed = 1;
+int width = 0;
+
+int main(int argc, char** argv) {
+	program_name = argv[0];
+	int c;
+	while ((c = getopt(argc, argv, "d:s:w:")) != -1) {
+		switch (c) {
+			case 'd':
+				depth = strtol(optarg, NULL, 10);
+				break;
+			case 's':
+				seed = strtoul(optarg, NULL, 10);
+				break;
+			case 'w':
+				width = strtol(optarg, NULL, 10);
+				break;
+			case '?':
+				exit(-1);
+			default:
+				break;
+		}
+	}
+	if (depth < 1 || depth > MAX_DEPTH) {
+		fprintf(stderr, "%s: depth must be between 1 and %i\n", program_name, MAX_DEPTH);
+		exit(-1);
+	}
+	config = *presets[0].config;
+	if (width > 0)
+		config.width = width;
+	if (config.next_piece_queue_size < depth)
+		config.next_piece_queue_size = depth;
+	if (config.width > BITBOARD_MAX_WIDTH || config.full_height > BITBOARD_MAX_HEIGHT) {
+		fprintf(stderr, "%s: board must be at most %ix%i\n", program_name, BITBOARD_MAX_WIDTH, BITBOARD_MAX_HEIGHT);
+		exit(-1);
+	}
+	init_piece_table();
+	init_piece_shapes();
+	init_citrus(seed);
+	int queue[MAX_DEPTH];
+	for (int i = 0; i < depth; i++)
+		queue[i] = piece_id(CitrusGame_get_next_piece(&game, i));
+	Bitboard bitboard = {.width = config.width, .height = config.full_height};
+	Generator generator;
+	generator_init(&generator, config.width, config.full_height, config.height);
+	printf("%-6s %14s %10s %14s\n", "depth", "nodes", "seconds", "nodes/s");
+	for (int d = 1; d <= depth; d++) {
+		double start = now();
+		uint64_t nodes = perft(&generator, &bitboard, queue, d);
+		double elapsed = now() - start;
+		printf("%-6i %14llu %10.3f %14.0f\n", d, (unsigned long long) nodes, elapsed, nodes / elapsed);
+	}
+	generator_free(&generator);
+	free_citrus();
+	return 0;
+}
@@ -0,0 +1,174 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "game.h"
+#include "profile.h"
+
+// Times the phases of the main loop. Each phase has a histogram for the
+// whole game and one for the last second, which is what the stats overlay
+// shows. With --trace, every phase is also written out as a Chrome trace
+// event, which can be opened in chrome://tracing or Perfetto. The render
+// thread records its phases too, so recording and reading stats take a lock,
+// and each thread's events go on their own track.
+
+// each power of two is split into 4 buckets, so percentiles are within 19%
+#define SUB_BUCKETS 4
+#define N_BUCKETS (40 * SUB_BUCKETS)
+#define RECENT_INTERVAL 1.0
+
+typedef struct {
+	int count;
+	uint64_t max;
+	int buckets[N_BUCKETS];
+} Histogram;
+
+bool profiling = false;
+const char* phase_names[N_PHASES] = {"wait", "input", "tick", "update", "flush"};
+Histogram histograms[N_PHASES];
+Histogram current[N_PHASES];
+Histogram recent[N_PHASES];
+double recent_start;
+double profile_start_time;
+FILE* trace_file = NULL;
+bool first_event = true;
+pthread_mutex_t profile_lock = PTHREAD_MUTEX_INITIALIZER;
+_Thread_local int profile_thread = 1;
+// how long after starting the backend was ready and the first frame shown
+double startup_init = -1;
+double startup_first_frame = -1;
+
+void profile_set_thread(int thread) {
+	profile_thread = thread;
+}
+
+// Starts timing. If trace_path isn't NULL, a trace is written there too.
+bool profile_start(const char* trace_path) {
+	if (trace_path != NULL) {
+		trace_file = fopen(trace_path, "w");
+		if (trace_file == NULL)
+			return false;
+		setvbuf(trace_file, NULL, _IOFBF, 1 << 16);
+		fputs("{\"traceEvents\":[\n", trace_file);
+	}
+	profile_start_time = recent_start = now();
+	profiling = true;
+	return true;
+}
+
+int bucket(uint64_t ns) {
+	if (ns < SUB_BUCKETS)
+		return ns;
+	int exponent = 63 - __builtin_clzll(ns);
+	int sub = (ns >> (exponent - 2)) & (SUB_BUCKETS - 1);
+	int i = (exponent - 1) * SUB_BUCKETS + sub;
+	return i < N_BUCKETS ? i : N_BUCKETS - 1;
+}
+
+// the largest time that falls into a bucket, in nanoseconds
+double bucket_limit(int i) {
+	if (i < SUB_BUCKETS)
+		return i;
+	int exponent = i / SUB_BUCKETS + 1;
+	int sub = i % SUB_BUCKETS;
+	return (double) ((uint64_t) (SUB_BUCKETS + sub + 1) << (exponent - 2)) - 1;
+}
+
+void histogram_add(Histogram* histogram, uint64_t ns) {
+	histogram->count++;
+	histogram->buckets[bucket(ns)]++;
+	if (ns > histogram->max)
+		histogram->max = ns;
+}
+
+double percentile(const Histogram* histogram, double p) {
+	int target = histogram->count * p;
+	int seen = 0;
+	for (int i = 0; i < N_BUCKETS; i++) {
+		seen += histogram->buckets[i];
+		if (seen > target) {
+			double limit = bucket_limit(i);
+			return limit < histogram->max ? limit : histogram->max;
+		}
+	}
+	return histogram->max;
+}
+
+void profile_record(Phase phase, double start, double end) {
+	if (!profiling)
+		return;
+	uint64_t ns = (end - start) * 1e9;
+	pthread_mutex_lock(&profile_lock);
+	histogram_add(&histograms[phase], ns);
+	histogram_add(&current[phase], ns);
+	if (end - recent_start >= RECENT_INTERVAL) {
+		memcpy(recent, current, sizeof(recent));
+		memset(current, 0, sizeof(current));
+		recent_start = end;
+	}
+	if (trace_file != NULL) {
+		fprintf(trace_file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%i}",
+			first_event ? "" : ",\n", phase_names[phase],
+			(start - profile_start_time) * 1e6, (end - start) * 1e6, profile_thread);
+		first_event = false;
+	}
+	pthread_mutex_unlock(&profile_lock);
+}
+
+void profile_startup(double start, double init_end, double first_frame) {
+	startup_init = init_end - start;
+	startup_first_frame = first_frame - start;
+}
+
+// Gets the times for a phase in microseconds, either over the whole game or
+// over the last second.
+void profile_get_stats(Phase phase, bool last_second, PhaseStats* stats) {
+	pthread_mutex_lock(&profile_lock);
+	const Histogram* histogram = last_second ? &recent[phase] : &histograms[phase];
+	stats->count = histogram->count;
+	stats->p50 = percentile(histogram, 0.5) / 1e3;
+	stats->p99 = percentile(histogram, 0.99) / 1e3;
+	stats->max = histogram->max / 1e3;
+	pthread_mutex_unlock(&profile_lock);
+}
+
+void profile_report(void) {
+	if (!profiling)
+		return;
+	fprintf(stderr, "%-8s %10s %10s %10s %10s\n", "phase", "count", "p50 us", "p99 us", "max us");
+	for (int i = 0; i < N_PHASES; i++) {
+		PhaseStats stats;
+		profile_get_stats(i, false, &stats);
+		fprintf(stderr, "%-8s %10i %10.1f %10.1f %10.1f\n", phase_names[i], stats.count, stats.p50, stats.p99, stats.max);
+	}
+	if (startup_first_frame >= 0)
+		fprintf(stderr, "first frame %.1f ms after start, %.1f ms of it starting the backend\n", startup_first_frame * 1e3, startup_init * 1e3);
+}
+
+void profile_stop(void) {
+	if (trace_file != NULL) {
+		fputs("\n]}\n", trace_file);
+		fclose(trace_file);
+		trace_file = NULL;
+	}
+	profiling = false;
+}
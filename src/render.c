@@ -0,0 +1,181 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "input.h"
+#include "profile.h"
+#include "render.h"
+
+// With backends that can be used from another thread, frames are drawn on a
+// render thread, so that a slow terminal can't hold up the game. After a
+// tick the main loop copies what is on screen into a frame, and the render
+// thread draws the newest frame that it hasn't drawn yet. Frames are passed
+// through a triple buffer: the main loop writes one, the render thread
+// reads another, and the third is the newest complete frame, which they
+// swap theirs with. Frames that the render thread is too slow to draw are
+// skipped.
+
+// how often the render thread checks whether it should stop
+#define RENDER_POLL 0.25
+// set on the shared frame's index until the render thread takes it
+#define FRAME_FRESH 4
+
+typedef struct {
+	View view;
+	CitrusCell* board;
+	const CitrusPiece** next_pieces;
+	char action_text[ACTION_TEXT_SIZE];
+	View opponent;
+	CitrusCell* opponent_board;
+	char opponent_action_text[ACTION_TEXT_SIZE];
+} RenderFrame;
+
+RenderFrame render_frames[3];
+int render_writing = 0;
+int render_reading = 1;
+atomic_uint render_shared = 2;
+atomic_bool render_running = false;
+bool render_threaded = false;
+pthread_t render_thread;
+pthread_mutex_t render_wait_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t render_wait_cond;
+
+// takes the newest frame, if there is one that hasn't been drawn
+bool render_take(void) {
+	if (!(atomic_load_explicit(&render_shared, memory_order_relaxed) & FRAME_FRESH))
+		return false;
+	render_reading = atomic_exchange_explicit(&render_shared, render_reading, memory_order_acq_rel) & ~FRAME_FRESH;
+	return true;
+}
+
+void* render_thread_main(void* data) {
+	(void) data;
+	profile_set_thread(2);
+	while (atomic_load(&render_running)) {
+		if (!render_take()) {
+			struct timespec t;
+			clock_gettime(CLOCK_MONOTONIC, &t);
+			t.tv_nsec += RENDER_POLL * 1e9;
+			if (t.tv_nsec >= 1000000000) {
+				t.tv_sec++;
+				t.tv_nsec -= 1000000000;
+			}
+			pthread_mutex_lock(&render_wait_lock);
+			while (atomic_load(&render_running) && !(atomic_load(&render_shared) & FRAME_FRESH)) {
+				if (pthread_cond_timedwait(&render_wait_cond, &render_wait_lock, &t) != 0)
+					break;
+			}
+			pthread_mutex_unlock(&render_wait_lock);
+			continue;
+		}
+		backend.lock();
+		double start = now();
+		draw_view(&render_frames[render_reading].view);
+		profile_record(PHASE_UPDATE, start, now());
+		backend.unlock();
+	}
+	return NULL;
+}
+
+// Starts drawing on the render thread, if the backend allows it. Until
+// render_stop, the main thread must only use the backend between
+// render_lock and render_unlock.
+bool render_start(void) {
+	if (!backend.threaded_input)
+		return false;
+	size_t board_size = sizeof(CitrusCell) * config.width * config.full_height;
+	for (int i = 0; i < 3; i++) {
+		render_frames[i].board = malloc(board_size);
+		render_frames[i].next_pieces = malloc(sizeof(CitrusPiece*) * config.next_piece_queue_size);
+		render_frames[i].opponent_board = malloc(board_size);
+	}
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&render_wait_cond, &attr);
+	pthread_condattr_destroy(&attr);
+	input_release_backend();
+	render_threaded = true;
+	atomic_store(&render_running, true);
+	pthread_create(&render_thread, NULL, render_thread_main, NULL);
+	return true;
+}
+
+// Copies a view into the frame being written, and hands it to the render
+// thread.
+void render_publish(const View* view) {
+	if (!render_threaded)
+		return;
+	RenderFrame* frame = &render_frames[render_writing];
+	memcpy(frame->board, view->board, sizeof(CitrusCell) * config.width * config.full_height);
+	memcpy(frame->next_pieces, view->next_pieces, sizeof(CitrusPiece*) * config.next_piece_queue_size);
+	strcpy(frame->action_text, view->action_text);
+	frame->view = *view;
+	frame->view.board = frame->board;
+	frame->view.next_pieces = frame->next_pieces;
+	frame->view.action_text = frame->action_text;
+	if (view->opponent != NULL) {
+		memcpy(frame->opponent_board, view->opponent->board, sizeof(CitrusCell) * config.width * config.full_height);
+		frame->opponent = *view->opponent;
+		frame->opponent.board = frame->opponent_board;
+		strcpy(frame->opponent_action_text, view->opponent->action_text);
+		frame->opponent.action_text = frame->opponent_action_text;
+		frame->view.opponent = &frame->opponent;
+	}
+	render_writing = atomic_exchange_explicit(&render_shared, render_writing | FRAME_FRESH, memory_order_acq_rel) & ~FRAME_FRESH;
+	pthread_mutex_lock(&render_wait_lock);
+	pthread_cond_signal(&render_wait_cond);
+	pthread_mutex_unlock(&render_wait_lock);
+}
+
+void render_lock(void) {
+	if (render_threaded)
+		backend.lock();
+}
+
+void render_unlock(void) {
+	if (render_threaded)
+		backend.unlock();
+}
+
+// Stops the render thread after it has drawn the newest frame, and gives the
+// backend back to the main thread.
+void render_stop(void) {
+	if (!render_threaded)
+		return;
+	atomic_store(&render_running, false);
+	pthread_mutex_lock(&render_wait_lock);
+	pthread_cond_signal(&render_wait_cond);
+	pthread_mutex_unlock(&render_wait_lock);
+	pthread_join(render_thread, NULL);
+	render_threaded = false;
+	input_take_backend();
+	if (render_take())
+		draw_view(&render_frames[render_reading].view);
+	pthread_cond_destroy(&render_wait_cond);
+	for (int i = 0; i < 3; i++) {
+		free(render_frames[i].board);
+		free(render_frames[i].next_pieces);
+		free(render_frames[i].opponent_board);
+	}
+}
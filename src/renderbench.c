@@ -0,0 +1,290 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <pty.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "game.h"
+
+// Draws the same games through each real backend with nobody watching.
+// Terminal backends write to a pseudo-terminal whose output is drained and
+// counted, and SDL3 uses its dummy video driver and software renderer.
+// Every run is in its own process, so that the peak RSS is its own and the
+// backends don't see each other's global state.
+
+#ifdef NCURSES_BACKEND
+extern Backend ncurses_backend;
+#endif
+#ifdef SDL3_BACKEND
+extern Backend sdl3_backend;
+extern const char* font_path;
+#endif
+#ifdef ANSI_BACKEND
+extern Backend ansi_backend;
+#endif
+
+typedef struct {
+	const char* name;
+	Backend* backend;
+	bool terminal;
+} BenchBackend;
+
+typedef struct {
+	int width;
+	int full_height;
+	int queue;
+} BoardSize;
+
+const BenchBackend bench_backends[] = {
+#ifdef NCURSES_BACKEND
+	{"ncurses", &ncurses_backend, true},
+#endif
+#ifdef ANSI_BACKEND
+	{"ansi", &ansi_backend, true},
+#endif
+#ifdef SDL3_BACKEND
+	{"sdl3", &sdl3_backend, false},
+#endif
+};
+const int n_bench_backends = sizeof(bench_backends) / sizeof(bench_backends[0]);
+
+const BoardSize board_sizes[] = {
+	{10, 40, 5},
+	{10, 40, 1},
+	{20, 60, 7},
+	{40, 100, 5},
+	{100, 250, 5},
+};
+const int n_board_sizes = sizeof(board_sizes) / sizeof(board_sizes[0]);
+
+const char* program_name;
+int n_frames = 2000;
+unsigned int seed = 1;
+Backend real_backend;
+long long draw_calls = 0;
+atomic_llong pty_bytes = 0;
+int pty_master = -1;
+
+// Every backend call that draws something goes through these, to be
+// counted.
+
+void count_full_update(void) {
+	draw_calls++;
+	real_backend.full_update();
+}
+
+void count_update(Window window) {
+	draw_calls++;
+	real_backend.update(window);
+}
+
+void count_print(int y, int x, const char* format, ...) {
+	char text[512];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(text, sizeof(text), format, args);
+	va_end(args);
+	draw_calls++;
+	real_backend.print(y, x, "%s", text);
+}
+
+void count_erase_window(Window window) {
+	draw_calls++;
+	real_backend.erase_window(window);
+}
+
+void count_erase_line(int x, int y) {
+	draw_calls++;
+	real_backend.erase_line(x, y);
+}
+
+void count_clear_screen(void) {
+	draw_calls++;
+	real_backend.clear_screen();
+}
+
+void count_draw_cell(Window window, int x, int y, int color) {
+	draw_calls++;
+	real_backend.draw_cell(window, x, y, color);
+}
+
+void count_draw_box(Window window) {
+	draw_calls++;
+	real_backend.draw_box(window);
+}
+
+void* drain_pty(void* data) {
+	(void) data;
+	char buffer[65536];
+	ssize_t n;
+	// this ends when the other side of the pty is closed
+	while ((n = read(pty_master, buffer, sizeof(buffer))) > 0)
+		atomic_fetch_add(&pty_bytes, n);
+	return NULL;
+}
+
+uint32_t rng_state;
+
+uint32_t bench_random(void) {
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+void bench(const BenchBackend* bench_backend, const BoardSize* size, FILE* report) {
+	pthread_t drain_thread;
+	if (bench_backend->terminal) {
+		int slave;
+		struct winsize window_size = {.ws_row = 80, .ws_col = 220};
+		if (openpty(&pty_master, &slave, NULL, NULL, &window_size) < 0) {
+			perror("openpty");
+			exit(-1);
+		}
+		setenv("TERM", "xterm-256color", 1);
+		dup2(slave, STDIN_FILENO);
+		dup2(slave, STDOUT_FILENO);
+		close(slave);
+		pthread_create(&drain_thread, NULL, drain_pty, NULL);
+	} else {
+		// without a display, unless another video driver was asked for
+		const char* driver = getenv("SDL_VIDEODRIVER");
+		setenv("SDL_VIDEO_DRIVER", driver != NULL ? driver : "dummy", 0);
+		setenv("SDL_RENDER_DRIVER", "software", 1);
+	}
+	config = citrus_preset_modern;
+	config.width = size->width;
+	config.full_height = size->full_height;
+	config.height = size->full_height > 40 ? size->full_height - 20 : size->full_height / 2;
+	config.next_piece_queue_size = size->queue;
+	real_backend = *bench_backend->backend;
+	backend = real_backend;
+	backend.full_update = count_full_update;
+	backend.update = count_update;
+	backend.print = count_print;
+	backend.erase_window = count_erase_window;
+	backend.erase_line = count_erase_line;
+	backend.clear_screen = count_clear_screen;
+	backend.draw_cell = count_draw_cell;
+	backend.draw_box = count_draw_box;
+	// from starting the backend to the first frame being shown, which for
+	// SDL3 includes making the window and getting the font ready
+	double init_start = now();
+	backend.init();
+	unsigned int game_seed = seed;
+	rng_state = seed | 1;
+	init_citrus(game_seed);
+	init_windows();
+	update();
+	double first_frame = now() - init_start;
+	draw_calls = 0;
+	double render_time = 0;
+	for (int i = 0; i < n_frames; i++) {
+		uint32_t r = bench_random();
+		if ((r & 3) == 0) {
+			int key = (r >> 2) % 10;
+			CitrusKey k = key >= 8 ? CITRUS_KEY_HARD_DROP : (CitrusKey) key;
+			CitrusGame_key_down(&game, k);
+			CitrusGame_key_up(&game, k);
+		}
+		CitrusGame_tick(&game);
+		ticks++;
+		if (!CitrusGame_is_alive(&game)) {
+			free_citrus();
+			init_citrus(++game_seed);
+		}
+		double start = now();
+		update();
+		render_time += now() - start;
+	}
+	long long calls = draw_calls;
+	backend.exit();
+	free_citrus();
+	long long bytes = 0;
+	if (bench_backend->terminal) {
+		// closing our side of the pty ends the drain thread
+		close(STDIN_FILENO);
+		close(STDOUT_FILENO);
+		pthread_join(drain_thread, NULL);
+		bytes = atomic_load(&pty_bytes);
+	}
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	char board[16];
+	snprintf(board, sizeof(board), "%ix%i", size->width, size->full_height);
+	fprintf(report, "%-8s %-8s %5i %10.0f %12.1f %10.1f %10li %9.1f\n", bench_backend->name, board, size->queue,
+		n_frames / render_time, bench_backend->terminal ? (double) bytes / n_frames : 0.0,
+		(double) calls / n_frames, usage.ru_maxrss, first_frame * 1e3);
+	fflush(report);
+}
+
+int main(int argc, char** argv) {
+	program_name = argv[0];
+	int c;
+	while ((c = getopt(argc, argv, "F:n:s:")) != -1) {
+		switch (c) {
+			case 'n':
+				n_frames = strtol(optarg, NULL, 10);
+				break;
+			case 's':
+				seed = strtoul(optarg, NULL, 10);
+				break;
+			case 'F':
+#ifdef SDL3_BACKEND
+				font_path = optarg;
+#endif
+				break;
+			case '?':
+				exit(-1);
+			default:
+				break;
+		}
+	}
+	if (n_frames <= 0) {
+		fprintf(stderr, "%s: frame count must be positive\n", program_name);
+		exit(-1);
+	}
+	// the runs write their results here, since their stdout is a pty
+	FILE* report = fdopen(dup(STDOUT_FILENO), "w");
+	printf("%-8s %-8s %5s %10s %12s %10s %10s %9s\n", "backend", "board", "queue", "frames/s", "bytes/frame", "calls/frame", "peak KiB", "first ms");
+	fflush(stdout);
+	for (int i = 0; i < n_bench_backends; i++) {
+		for (int j = 0; j < n_board_sizes; j++) {
+			pid_t pid = fork();
+			if (pid == 0) {
+				bench(&bench_backends[i], &board_sizes[j], report);
+				exit(0);
+			}
+			int status;
+			waitpid(pid, &status, 0);
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+				printf("%s failed on %ix%i\n", bench_backends[i].name, board_sizes[j].width, board_sizes[j].full_height);
+			fflush(stdout);
+		}
+	}
+	fclose(report);
+	return 0;
+}
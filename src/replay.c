@@ -0,0 +1,271 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "game.h"
+#include "replay.h"
+
+// A replay is a header with the game config and randomizer seed, followed
+// by one varint per key event. Each event packs the number of ticks since
+// the previous event, the key and whether it was pressed or released, so
+// most events take a single byte. The game ends with an event using
+// END_KEY, followed by the final score and lines for verification.
+
+#define REPLAY_MAGIC "TXRP"
+#define REPLAY_VERSION 1
+#define END_KEY 15
+
+FILE* record_file = NULL;
+int record_tick = 0;
+
+FILE* replay_file = NULL;
+bool replaying = false;
+bool replay_ended = false;
+int replay_tick = 0;
+int replay_key = -1;
+bool replay_up = false;
+int end_ticks = -1;
+int end_score = 0;
+int end_lines = 0;
+
+void write_varint(FILE* file, uint64_t value) {
+	while (value >= 0x80) {
+		fputc((value & 0x7f) | 0x80, file);
+		value >>= 7;
+	}
+	fputc(value, file);
+}
+
+bool read_varint(FILE* file, uint64_t* value) {
+	*value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		int c = fgetc(file);
+		if (c == EOF)
+			return false;
+		*value |= (uint64_t) (c & 0x7f) << shift;
+		if ((c & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+
+// zigzag encoding, so that small negative numbers stay small
+void write_int(FILE* file, int value) {
+	write_varint(file, ((uint64_t) value << 1) ^ (uint64_t) (value < 0 ? -1 : 0));
+}
+
+bool read_int(FILE* file, int* value) {
+	uint64_t v;
+	if (!read_varint(file, &v))
+		return false;
+	*value = (int) (v >> 1) ^ -(int) (v & 1);
+	return true;
+}
+
+bool replay_record_start(const char* path, int preset, unsigned int seed) {
+	record_file = fopen(path, "wb");
+	if (record_file == NULL)
+		return false;
+	record_tick = 0;
+	fwrite(REPLAY_MAGIC, 1, 4, record_file);
+	fputc(REPLAY_VERSION, record_file);
+	fputc(preset, record_file);
+	fputc(config.randomizer == CitrusBagRandomizer_randomizer ? 0 : 1, record_file);
+	write_varint(record_file, seed);
+	write_int(record_file, config.width);
+	write_int(record_file, config.height);
+	write_int(record_file, config.full_height);
+	write_int(record_file, config.lock_delay);
+	write_int(record_file, config.max_move_reset);
+	write_int(record_file, config.next_piece_queue_size);
+	write_int(record_file, config.line_clear_delay);
+	write_int(record_file, config.shadow);
+	write_int(record_file, config.arr);
+	write_int(record_file, config.das);
+	uint64_t gravity;
+	double g = config.gravity;
+	memcpy(&gravity, &g, sizeof(gravity));
+	write_varint(record_file, gravity);
+	return true;
+}
+
+void record_event(int key, bool up) {
+	write_varint(record_file, (uint64_t) (ticks - record_tick) << 5 | key << 1 | up);
+	record_tick = ticks;
+}
+
+void replay_record_key(CitrusKey key, bool up) {
+	if (record_file != NULL)
+		record_event(key, up);
+}
+
+void replay_record_end(void) {
+	if (record_file == NULL)
+		return;
+	record_event(END_KEY, false);
+	write_int(record_file, game.score);
+	write_int(record_file, game.lines);
+	fclose(record_file);
+	record_file = NULL;
+}
+
+// reads the next event into replay_tick, replay_key and replay_up
+void read_event(void) {
+	uint64_t v;
+	if (replay_ended || !read_varint(replay_file, &v)) {
+		replay_ended = true;
+		return;
+	}
+	replay_tick += v >> 5;
+	replay_key = (v >> 1) & 15;
+	replay_up = v & 1;
+	if (replay_key == END_KEY) {
+		end_ticks = replay_tick;
+		read_int(replay_file, &end_score);
+		read_int(replay_file, &end_lines);
+		replay_ended = true;
+	}
+}
+
+// Checks every event up to the end, so that a damaged replay is turned down
+// when it is opened instead of pressing keys that don't exist. A replay that
+// stops without an end event is fine, since the game that was recording it
+// may not have finished.
+bool events_valid(void) {
+	long start = ftell(replay_file);
+	uint64_t v;
+	bool valid = true;
+	while (valid && read_varint(replay_file, &v)) {
+		int key = (v >> 1) & 15;
+		if (key == END_KEY)
+			break;
+		valid = valid_key(key);
+	}
+	fseek(replay_file, start, SEEK_SET);
+	return valid;
+}
+
+// Loads the config from a replay into config. The caller then has to start
+// the game with init_citrus and the returned seed.
+bool replay_open(const char* path, unsigned int* seed) {
+	replay_file = fopen(path, "rb");
+	if (replay_file == NULL)
+		return false;
+	char magic[4];
+	if (fread(magic, 1, 4, replay_file) != 4 || memcmp(magic, REPLAY_MAGIC, 4) != 0)
+		goto fail;
+	if (fgetc(replay_file) != REPLAY_VERSION)
+		goto fail;
+	int preset = fgetc(replay_file);
+	int randomizer_type = fgetc(replay_file);
+	if (preset < 0 || preset >= N_PRESETS || randomizer_type < 0)
+		goto fail;
+	config = *presets[preset].config;
+	config.randomizer = randomizer_type == 0 ? CitrusBagRandomizer_randomizer : CitrusClassicRandomizer_randomizer;
+	uint64_t v;
+	bool ok = read_varint(replay_file, &v);
+	*seed = v;
+	ok = ok && read_int(replay_file, &config.width);
+	ok = ok && read_int(replay_file, &config.height);
+	ok = ok && read_int(replay_file, &config.full_height);
+	ok = ok && read_int(replay_file, &config.lock_delay);
+	ok = ok && read_int(replay_file, &config.max_move_reset);
+	ok = ok && read_int(replay_file, &config.next_piece_queue_size);
+	ok = ok && read_int(replay_file, &config.line_clear_delay);
+	ok = ok && read_int(replay_file, &config.shadow);
+	ok = ok && read_int(replay_file, &config.arr);
+	ok = ok && read_int(replay_file, &config.das);
+	ok = ok && read_varint(replay_file, &v);
+	if (!ok)
+		goto fail;
+	double gravity;
+	memcpy(&gravity, &v, sizeof(gravity));
+	config.gravity = gravity;
+	// everything is sized from these, so they get the options' limits
+	if (!valid_board_size(config.width, config.full_height, config.next_piece_queue_size)
+		|| config.height < -1 || config.height > config.full_height
+		|| config.lock_delay < 1 || config.max_move_reset < 0 || config.line_clear_delay < 0
+		|| config.shadow < 0 || config.arr < 0 || config.das < 0 || !(gravity >= 0 && gravity <= INT_MAX))
+		goto fail;
+	if (!events_valid())
+		goto fail;
+	replaying = true;
+	replay_ended = false;
+	replay_tick = 0;
+	end_ticks = -1;
+	read_event();
+	return true;
+fail:
+	fclose(replay_file);
+	replay_file = NULL;
+	return false;
+}
+
+// Sends the key events recorded for the current tick to the game.
+void replay_apply(void) {
+	while (!replay_ended && replay_tick == ticks) {
+		if (replay_up)
+			CitrusGame_key_up(&game, replay_key);
+		else
+			CitrusGame_key_down(&game, replay_key);
+		read_event();
+	}
+}
+
+bool replay_finished(void) {
+	return replay_ended && ticks >= end_ticks;
+}
+
+// Checks that the game ended the same way as when it was recorded.
+bool replay_verify(void) {
+	while (!replay_ended)
+		read_event();
+	return end_ticks == ticks && end_score == game.score && end_lines == game.lines;
+}
+
+void replay_get_cursor(ReplayCursor* cursor) {
+	memset(cursor, 0, sizeof(ReplayCursor));
+	if (!replaying)
+		return;
+	cursor->offset = ftell(replay_file);
+	cursor->tick = replay_tick;
+	cursor->key = replay_key;
+	cursor->up = replay_up;
+	cursor->ended = replay_ended;
+}
+
+void replay_set_cursor(const ReplayCursor* cursor) {
+	if (!replaying)
+		return;
+	fseek(replay_file, cursor->offset, SEEK_SET);
+	replay_tick = cursor->tick;
+	replay_key = cursor->key;
+	replay_up = cursor->up;
+	replay_ended = cursor->ended;
+}
+
+void replay_close(void) {
+	if (replay_file != NULL)
+		fclose(replay_file);
+	replay_file = NULL;
+	replaying = false;
+}
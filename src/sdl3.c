@@ -22,8 +22,13 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "backend.h"
 #include "citrus.h"
+#include "font.h"
+#include "game.h"
+
+extern const char* program_name;
 
 const SDL_Color colors[7] = {
 	[CITRUS_COLOR_I] = {89, 154, 209},
@@ -39,62 +44,407 @@ SDL_Window* window = NULL;
 SDL_Renderer* renderer = NULL;
 TTF_TextEngine* text_engine = NULL;
 TTF_Font* font = NULL;
+// the built in font, which is put into this texture once at startup and
+// drawn from without a font given with -F
+SDL_Texture* atlas = NULL;
+// everything is drawn onto the canvas, which keeps its contents between
+// frames so that only the parts of the screen that changed are redrawn
+SDL_Texture* canvas = NULL;
+
+#define TEXT_CACHE_SIZE 32
+#define TEXT_SIZE 512
+#define FONT_CACHE_SIZE 8
+// glyphs are a pixel apart in the atlas, so that scaling them doesn't
+// pick up the edges of their neighbours
+#define ATLAS_COLUMNS 16
+#define ATLAS_CELL_WIDTH (FONT_WIDTH + 2)
+#define ATLAS_CELL_HEIGHT (FONT_HEIGHT + 2)
+// the cell after the last glyph is solid, for filled rectangles
+#define ATLAS_SOLID FONT_GLYPHS
+#define ATLAS_ROWS (ATLAS_SOLID / ATLAS_COLUMNS + 1)
+// window resizes are only acted on this often, however many events come in
+#define RELAYOUT_INTERVAL 16000000
+
+// laid out text is kept for each position it was printed at, and is only
+// laid out again when the string printed there changes
+typedef struct {
+	int x;
+	int y;
+	char string[TEXT_SIZE];
+	TTF_Text* text;
+} CachedText;
+
+// fonts are kept open for each cell height they have been fitted to, so
+// that going back to a size while resizing doesn't load the font again
+typedef struct {
+	int size;
+	TTF_Font* font;
+	int last_used;
+} CachedFont;
+
+CachedText text_cache[TEXT_CACHE_SIZE];
+int text_cache_size = 0;
+int text_cache_next = 0;
+CachedFont font_cache[FONT_CACHE_SIZE];
+int font_cache_size = 0;
+int font_cache_uses = 0;
+// filled rectangles and text from the atlas are collected here during a
+// frame and submitted with a single SDL_RenderGeometry call
+SDL_Vertex* vertices = NULL;
+int* indices = NULL;
+int n_quads = 0;
+int quad_capacity = 0;
 int cell_width = 5;
 int cell_height = 10;
 int target_width = 50;
 int target_height = 50;
 const char* font_path = "";
+bool vsync = false;
+int canvas_width = 0;
+int canvas_height = 0;
+// the last window size that was seen, to be laid out at the next chance
+bool resize_pending = false;
+int pending_width, pending_height;
+Uint64 last_relayout = 0;
+// the size in cells that the game was last laid out for
+int layout_width = 0;
+int layout_height = 0;
+
+// Draws a glyph of the atlas, or the solid cell, over r.
+void push_glyph(SDL_FRect r, SDL_Color c, int glyph) {
+	if (n_quads == quad_capacity) {
+		quad_capacity = quad_capacity == 0 ? 256 : quad_capacity * 2;
+		vertices = realloc(vertices, sizeof(SDL_Vertex) * 4 * quad_capacity);
+		indices = realloc(indices, sizeof(int) * 6 * quad_capacity);
+		for (int i = n_quads; i < quad_capacity; i++) {
+			const int corners[6] = {0, 1, 2, 2, 3, 0};
+			for (int j = 0; j < 6; j++)
+				indices[i * 6 + j] = i * 4 + corners[j];
+		}
+	}
+	float width = ATLAS_COLUMNS * ATLAS_CELL_WIDTH;
+	float height = ATLAS_ROWS * ATLAS_CELL_HEIGHT;
+	SDL_FRect t = {
+		((glyph % ATLAS_COLUMNS) * ATLAS_CELL_WIDTH + 1) / width,
+		((glyph / ATLAS_COLUMNS) * ATLAS_CELL_HEIGHT + 1) / height,
+		FONT_WIDTH / width,
+		FONT_HEIGHT / height
+	};
+	SDL_FColor color = {c.r / 255.0f, c.g / 255.0f, c.b / 255.0f, 1.0f};
+	SDL_Vertex* v = &vertices[n_quads * 4];
+	v[0] = (SDL_Vertex) {{r.x, r.y}, color, {t.x, t.y}};
+	v[1] = (SDL_Vertex) {{r.x + r.w, r.y}, color, {t.x + t.w, t.y}};
+	v[2] = (SDL_Vertex) {{r.x + r.w, r.y + r.h}, color, {t.x + t.w, t.y + t.h}};
+	v[3] = (SDL_Vertex) {{r.x, r.y + r.h}, color, {t.x, t.y + t.h}};
+	n_quads++;
+}
+
+void push_quad(SDL_FRect r, SDL_Color c) {
+	push_glyph(r, c, ATLAS_SOLID);
+}
+
+void flush_quads(void) {
+	if (n_quads == 0)
+		return;
+	SDL_RenderGeometry(renderer, atlas, vertices, n_quads * 4, indices, n_quads * 6);
+	n_quads = 0;
+}
+
+// Puts the built in font into a texture, the only work done for text at
+// startup.
+void create_atlas(void) {
+	int width = ATLAS_COLUMNS * ATLAS_CELL_WIDTH;
+	int height = ATLAS_ROWS * ATLAS_CELL_HEIGHT;
+	Uint32* pixels = calloc(width * height, sizeof(Uint32));
+	for (int i = 0; i < FONT_GLYPHS; i++) {
+		int x0 = (i % ATLAS_COLUMNS) * ATLAS_CELL_WIDTH + 1;
+		int y0 = (i / ATLAS_COLUMNS) * ATLAS_CELL_HEIGHT + 1;
+		for (int y = 0; y < FONT_HEIGHT; y++) {
+			for (int x = 0; x < FONT_WIDTH; x++) {
+				char c = font_glyphs[i][y][x];
+				Uint32 alpha = c == '.' ? 0 : (c <= '9' ? c - '0' : c - 'a' + 10) * 17;
+				pixels[(y0 + y) * width + x0 + x] = alpha << 24 | 0xffffff;
+			}
+		}
+	}
+	// the whole of the solid cell is filled, so its edges stay solid
+	int x0 = (ATLAS_SOLID % ATLAS_COLUMNS) * ATLAS_CELL_WIDTH;
+	int y0 = (ATLAS_SOLID / ATLAS_COLUMNS) * ATLAS_CELL_HEIGHT;
+	for (int y = 0; y < ATLAS_CELL_HEIGHT; y++) {
+		for (int x = 0; x < ATLAS_CELL_WIDTH; x++)
+			pixels[(y0 + y) * width + x0 + x] = 0xffffffff;
+	}
+	atlas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, width, height);
+	SDL_UpdateTexture(atlas, NULL, pixels, width * sizeof(Uint32));
+	SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+	SDL_SetTextureScaleMode(atlas, SDL_SCALEMODE_LINEAR);
+	free(pixels);
+}
+
+// The canvas only grows, so shrinking the window doesn't lose what is drawn
+// on it. It is made big enough for the window, and cleared.
+void create_canvas(void) {
+	int width, height;
+	n_quads = 0;
+	SDL_SetRenderTarget(renderer, NULL);
+	if (canvas != NULL)
+		SDL_DestroyTexture(canvas);
+	SDL_GetRenderOutputSize(renderer, &width, &height);
+	canvas_width = SDL_max(width, canvas_width);
+	canvas_height = SDL_max(height, canvas_height);
+	canvas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, canvas_width, canvas_height);
+	SDL_SetRenderTarget(renderer, canvas);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+	SDL_RenderClear(renderer);
+}
+
+void clear_text_cache(void) {
+	for (int i = 0; i < text_cache_size; i++)
+		TTF_DestroyText(text_cache[i].text);
+	text_cache_size = 0;
+	text_cache_next = 0;
+}
+
+TTF_Text* get_text(int x, int y, const char* string) {
+	CachedText* entry = NULL;
+	for (int i = 0; i < text_cache_size; i++) {
+		if (text_cache[i].x == x && text_cache[i].y == y) {
+			entry = &text_cache[i];
+			break;
+		}
+	}
+	if (entry == NULL) {
+		if (text_cache_size < TEXT_CACHE_SIZE) {
+			entry = &text_cache[text_cache_size++];
+		} else {
+			// evict the oldest entry
+			entry = &text_cache[text_cache_next];
+			text_cache_next = (text_cache_next + 1) % TEXT_CACHE_SIZE;
+			TTF_DestroyText(entry->text);
+		}
+		entry->x = x;
+		entry->y = y;
+		entry->text = TTF_CreateText(text_engine, font, string, 0);
+	} else if (strcmp(entry->string, string) != 0) {
+		TTF_SetTextString(entry->text, string, 0);
+	}
+	strcpy(entry->string, string);
+	return entry->text;
+}
+
+// Text has to stay inside the cells it is printed in, since anything drawn
+// outside them would be left on the canvas, so the font is shrunk until its
+// characters fit a cell.
+TTF_Font* open_font(void) {
+	TTF_Font* f = TTF_OpenFont(font_path, cell_height);
+	if (f == NULL)
+		return NULL;
+	float size = cell_height;
+	int width, height;
+	while (size > 1 && TTF_GetStringSize(f, "M", 0, &width, &height) && (width > cell_width || height > cell_height)) {
+		size = SDL_min(size - 0.5f, size * SDL_min((float) cell_width / width, (float) cell_height / height));
+		TTF_SetFontSize(f, size);
+	}
+	return f;
+}
+
+TTF_Font* get_font(void) {
+	CachedFont* entry = NULL;
+	for (int i = 0; i < font_cache_size; i++) {
+		if (font_cache[i].size == cell_height) {
+			entry = &font_cache[i];
+			break;
+		}
+	}
+	if (entry == NULL) {
+		if (font_cache_size < FONT_CACHE_SIZE) {
+			entry = &font_cache[font_cache_size++];
+		} else {
+			// evict the least recently used font
+			entry = &font_cache[0];
+			for (int i = 1; i < FONT_CACHE_SIZE; i++) {
+				if (font_cache[i].last_used < entry->last_used)
+					entry = &font_cache[i];
+			}
+			TTF_CloseFont(entry->font);
+		}
+		entry->size = cell_height;
+		entry->font = open_font();
+	}
+	entry->last_used = font_cache_uses++;
+	return entry->font;
+}
+
+void sdl3_get_size(int* width, int* height);
+
+bool using_ttf(void) {
+	return font_path[0] != '\0';
+}
 
 void sdl3_init(void) {
 	SDL_Init(SDL_INIT_VIDEO);
-	TTF_Init();
 	window = SDL_CreateWindow("txtris", cell_width * target_width, cell_height * target_height, SDL_WINDOW_RESIZABLE);
-	renderer = SDL_CreateRenderer(window, NULL);
-	text_engine = TTF_CreateRendererTextEngine(renderer);
-	font = TTF_OpenFont(font_path, cell_height);
-	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-	SDL_RenderClear(renderer);
+	if (window != NULL)
+		renderer = SDL_CreateRenderer(window, NULL);
+	if (renderer == NULL) {
+		fprintf(stderr, "%s: can't open a window: %s\n", program_name, SDL_GetError());
+		exit(-1);
+	}
+	if (vsync)
+		SDL_SetRenderVSync(renderer, 1);
+	create_atlas();
+	if (using_ttf()) {
+		TTF_Init();
+		text_engine = TTF_CreateRendererTextEngine(renderer);
+		font = get_font();
+	}
+	create_canvas();
+	sdl3_get_size(&layout_width, &layout_height);
 }
 
 void sdl3_exit(void) {
+	if (using_ttf()) {
+		clear_text_cache();
+		TTF_DestroyRendererTextEngine(text_engine);
+		for (int i = 0; i < font_cache_size; i++)
+			TTF_CloseFont(font_cache[i].font);
+		font_cache_size = 0;
+		TTF_Quit();
+	}
+	SDL_DestroyTexture(atlas);
+	SDL_DestroyTexture(canvas);
+	free(vertices);
+	free(indices);
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
 	SDL_Quit();
 }
 
-KeyType sdl3_get_key(int timeout, int* key) {
-	SDL_Event event;
-	if (SDL_WaitEventTimeout(&event, timeout) == 0) {
-		return KEYTYPE_NONE;
+// Lays the window out again for the last size it was given. Returns true if
+// the game has to lay itself out and draw everything again, because the size
+// of the cells or the number of them changed, or the canvas was lost.
+bool apply_resize(void) {
+	int new_cell_width = pending_width / target_width;
+	int new_cell_height = pending_height / target_height;
+	if (new_cell_width * 2 > new_cell_height) {
+		new_cell_width = new_cell_height / 2;
+	}
+	if (new_cell_width < 1)
+		new_cell_width = 1;
+	new_cell_height = new_cell_width * 2;
+	bool changed = false;
+	int width, height;
+	SDL_GetRenderOutputSize(renderer, &width, &height);
+	if (width > canvas_width || height > canvas_height) {
+		create_canvas();
+		changed = true;
 	}
-	if (event.type == SDL_EVENT_QUIT)
-		exit(0);
-	if (event.type == SDL_EVENT_WINDOW_RESIZED) {
-		cell_width = event.window.data1 / target_width;
-		cell_height = event.window.data2 / target_height;
-		if (cell_width * 2 > cell_height) {
-			cell_width = cell_height / 2;
+	if (new_cell_width != cell_width || new_cell_height != cell_height) {
+		cell_width = new_cell_width;
+		cell_height = new_cell_height;
+		if (using_ttf()) {
+			clear_text_cache();
+			font = get_font();
 		}
-		cell_height = cell_width * 2;
-		TTF_CloseFont(font);
-		font = TTF_OpenFont(font_path, cell_height);
-		*key = K_RESIZE;
-		return KEYTYPE_PRESS;
-	}
-	if (event.type == SDL_EVENT_KEY_DOWN || event.type == SDL_EVENT_KEY_UP) {
-		if (event.key.repeat) {
+		changed = true;
+	}
+	sdl3_get_size(&width, &height);
+	if (width != layout_width || height != layout_height) {
+		layout_width = width;
+		layout_height = height;
+		changed = true;
+	}
+	return changed;
+}
+
+void present(void) {
+	int width, height;
+	SDL_GetRenderOutputSize(renderer, &width, &height);
+	SDL_FRect area = {0, 0, width, height};
+	SDL_SetRenderTarget(renderer, NULL);
+	SDL_RenderTexture(renderer, canvas, &area, &area);
+	SDL_RenderPresent(renderer);
+	SDL_SetRenderTarget(renderer, canvas);
+}
+
+// SDL events have to be read on the main thread, but they are timestamped
+// when SDL receives them, which is used as the time of the key press.
+// Window resizes are collected, and only the last one is laid out, once no
+// more are queued and at most once a frame, so dragging the edge of the
+// window doesn't lay out and redraw everything for every event.
+KeyType sdl3_get_key(double timeout, int* key, double* time) {
+	SDL_Event event;
+	Uint64 end = SDL_GetTicksNS() + timeout * 1e9;
+	while (true) {
+		Uint64 ticks = SDL_GetTicksNS();
+		Uint64 wait_end = end;
+		if (resize_pending) {
+			Uint64 relayout_time = last_relayout + RELAYOUT_INTERVAL;
+			if (ticks >= relayout_time && !SDL_HasEvent(SDL_EVENT_WINDOW_RESIZED)) {
+				resize_pending = false;
+				last_relayout = ticks;
+				if (apply_resize()) {
+					*time = now();
+					*key = K_RESIZE;
+					return KEYTYPE_PRESS;
+				}
+				// the layout is the same, but the window still has
+				// to be shown again at its new size
+				present();
+				continue;
+			}
+			if (relayout_time < wait_end)
+				wait_end = relayout_time;
+		}
+		if (SDL_WaitEventTimeout(&event, ticks < wait_end ? (wait_end - ticks) / 1000000 : 0) == 0) {
+			// SDL only waits for whole milliseconds, so wait out the rest,
+			// which is all of a wait shorter than a millisecond
+			ticks = SDL_GetTicksNS();
+			if (ticks < wait_end)
+				SDL_DelayPrecise(wait_end - ticks);
+			if (wait_end < end)
+				continue;
 			return KEYTYPE_NONE;
 		}
-		switch (event.key.key) {
-			case SDLK_LEFT: *key = K_LEFT; break;
-			case SDLK_RIGHT: *key = K_RIGHT; break;
-			case SDLK_UP: *key = K_UP; break;
-			case SDLK_DOWN: *key = K_DOWN; break;
-			default: *key = event.key.key;
+		// timestamps are in nanoseconds on the clock of SDL_GetTicksNS, so
+		// they are turned into how long ago the event happened
+		ticks = SDL_GetTicksNS();
+		*time = now() - (ticks > event.common.timestamp ? ticks - event.common.timestamp : 0) / 1e9;
+		if (event.type == SDL_EVENT_QUIT)
+			exit(0);
+		if (event.type == SDL_EVENT_WINDOW_RESIZED) {
+			pending_width = event.window.data1;
+			pending_height = event.window.data2;
+			resize_pending = true;
+			continue;
+		}
+		if (event.type == SDL_EVENT_RENDER_TARGETS_RESET || event.type == SDL_EVENT_RENDER_DEVICE_RESET) {
+			// the canvas lost what was drawn on it, so everything is
+			// drawn again like after a resize, and after a device reset
+			// the atlas has to be made again too
+			if (event.type == SDL_EVENT_RENDER_DEVICE_RESET) {
+				SDL_DestroyTexture(atlas);
+				create_atlas();
+			}
+			create_canvas();
+			*key = K_RESIZE;
+			return KEYTYPE_PRESS;
+		}
+		if (event.type == SDL_EVENT_KEY_DOWN || event.type == SDL_EVENT_KEY_UP) {
+			if (event.key.repeat) {
+				return KEYTYPE_NONE;
+			}
+			switch (event.key.key) {
+				case SDLK_LEFT: *key = K_LEFT; break;
+				case SDLK_RIGHT: *key = K_RIGHT; break;
+				case SDLK_UP: *key = K_UP; break;
+				case SDLK_DOWN: *key = K_DOWN; break;
+				default: *key = event.key.key;
+			}
+			return event.key.down ? KEYTYPE_DOWN : KEYTYPE_UP;
 		}
-		return event.key.down ? KEYTYPE_DOWN : KEYTYPE_UP;
+		return KEYTYPE_NONE;
 	}
-	return KEYTYPE_NONE;
 }
 
 void sdl3_init_window(Window* window) {
@@ -106,9 +456,8 @@ void sdl3_resize_window(Window* window) {
 }
 
 void sdl3_full_update(void) {
-	SDL_RenderPresent(renderer);
-	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-	SDL_RenderClear(renderer);
+	flush_quads();
+	present();
 }
 
 void sdl3_update(Window window) {
@@ -116,13 +465,35 @@ void sdl3_update(Window window) {
 }
 
 void sdl3_print(int y, int x, const char* fmt, ...) {
-	char buffer[512];
+	char buffer[TEXT_SIZE];
 	va_list args;
 	va_start(args, fmt);
 	vsnprintf(buffer, sizeof(buffer), fmt, args);
 	va_end(args);
-	TTF_Text* text = TTF_CreateText(text_engine, font, buffer, 0);
-	TTF_DrawRendererText(text, cell_width * x, cell_height * y);
+	if (!using_ttf()) {
+		// the glyphs are scaled to the cells, which keep the font's shape
+		int length = strlen(buffer);
+		push_quad((SDL_FRect) {cell_width * x, cell_height * y, cell_width * length, cell_height}, (SDL_Color) {0, 0, 0, 255});
+		for (int i = 0; i < length; i++) {
+			unsigned char c = buffer[i];
+			if (c == ' ')
+				continue;
+			if (c < FONT_FIRST || c > FONT_LAST)
+				c = '?';
+			SDL_FRect r = {cell_width * (x + i), cell_height * y, cell_width, cell_height};
+			push_glyph(r, (SDL_Color) {255, 255, 255, 255}, c - FONT_FIRST);
+		}
+		return;
+	}
+	SDL_Rect cells = {cell_width * x, cell_height * y, cell_width * strlen(buffer), cell_height};
+	push_quad((SDL_FRect) {cells.x, cells.y, cells.w, cells.h}, (SDL_Color) {0, 0, 0, 255});
+	// text is not batched, so everything under it has to be drawn first
+	flush_quads();
+	// a glyph can still reach a pixel past its cell, which nothing would
+	// erase, so the text is cut off at the edge of its cells
+	SDL_SetRenderClipRect(renderer, &cells);
+	TTF_DrawRendererText(get_text(x, y, buffer), cell_width * x, cell_height * y);
+	SDL_SetRenderClipRect(renderer, NULL);
 }
 
 void sdl3_erase_window(Window window) {
@@ -132,15 +503,23 @@ void sdl3_erase_window(Window window) {
 		window.width * cell_width,
 		window.height * cell_height
 	};
-	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-	SDL_RenderFillRect(renderer, &r);
+	push_quad(r, (SDL_Color) {0, 0, 0, 255});
 }
 
 void sdl3_erase_line(int x, int y) {
-	// TODO
+	int width, height;
+	SDL_GetCurrentRenderOutputSize(renderer, &width, &height);
+	SDL_FRect r = {
+		x * cell_width,
+		y * cell_height,
+		width - x * cell_width,
+		cell_height
+	};
+	push_quad(r, (SDL_Color) {0, 0, 0, 255});
 }
 
 void sdl3_clear_screen(void) {
+	n_quads = 0;
 	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
 	SDL_RenderClear(renderer);
 }
@@ -160,19 +539,19 @@ void sdl3_draw_cell(Window window, int x, int y, int color) {
 		cell_width * 2,
 		cell_height
 	};
-	SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
-	SDL_RenderFillRect(renderer, &r);
+	push_quad(r, c);
 }
 
 void sdl3_draw_box(Window window) {
-	SDL_FRect r = {
-		window.x * cell_width,
-		window.y * cell_height,
-		window.width * cell_width,
-		window.height * cell_height
-	};
-	SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-	SDL_RenderRect(renderer, &r);
+	float x = window.x * cell_width;
+	float y = window.y * cell_height;
+	float width = window.width * cell_width;
+	float height = window.height * cell_height;
+	SDL_Color white = {255, 255, 255, 255};
+	push_quad((SDL_FRect) {x, y, width, 1}, white);
+	push_quad((SDL_FRect) {x, y + height - 1, width, 1}, white);
+	push_quad((SDL_FRect) {x, y, 1, height}, white);
+	push_quad((SDL_FRect) {x + width - 1, y, 1, height}, white);
 }
 
 void sdl3_get_size(int* width, int* height) {
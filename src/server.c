@@ -0,0 +1,437 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+#include "game.h"
+#include "net.h"
+#include "server.h"
+
+// The server runs every game itself. Clients only send key presses and get
+// back changes to their board, their hold and next pieces and their score.
+// Players in the same room send garbage to each other.
+
+#define ROOM_SIZE 8
+#define MAX_EVENTS 256
+#define MAX_OUTPUT (1 << 20)
+#define MAX_CATCH_UP_TICKS 4
+#define STATS_INTERVAL 10.0
+
+typedef struct Room Room;
+
+typedef struct Player Player;
+
+struct Player {
+	int fd;
+	Buffer input;
+	Buffer output;
+	bool writing;
+	Room* room;
+	int number;
+	bool playing;
+	bool finished;
+	bool removed;
+	Player* next_removed;
+	CitrusGame game;
+	CitrusCell* board;
+	const CitrusPiece** next_piece_queue;
+	void* randomizer;
+	int* sent_board;
+	Buffer sent_state;
+	int pieces;
+	int ticks;
+	int attack_target;
+};
+
+struct Room {
+	int id;
+	Player* players[ROOM_SIZE];
+	Room* next;
+};
+
+Room* rooms = NULL;
+int epoll_fd;
+int listen_fd;
+int timer_fd;
+int n_players = 0;
+// disconnected players are only freed once the current batch of events has
+// been handled, since there may be more events for them
+Player* removed_players = NULL;
+
+void send_attack(Player* player, int lines) {
+	Room* room = player->room;
+	for (int i = 1; i < ROOM_SIZE; i++) {
+		int n = (player->attack_target + i) % ROOM_SIZE;
+		Player* target = room->players[n];
+		if (n == player->number || target == NULL || !target->playing)
+			continue;
+		player->attack_target = n;
+		size_t start = message_begin(&target->output, MSG_ATTACK);
+		put_varint(&target->output, player->number);
+		put_varint(&target->output, lines);
+		message_end(&target->output, start);
+		return;
+	}
+}
+
+void server_action_text_callback(void* data, int n_lines_cleared, int combo, bool b2b, bool all_clear, bool spin, bool mini_spin) {
+	Player* player = data;
+	player->pieces++;
+	int attack = clear_attack(n_lines_cleared, combo, b2b, all_clear, spin);
+	(void) mini_spin;
+	if (attack > 0)
+		send_attack(player, attack);
+}
+
+void start_game(Player* player) {
+	CitrusGameConfig player_config = config;
+	player_config.action_text = server_action_text_callback;
+	unsigned int seed = rand();
+	if (config.randomizer == CitrusBagRandomizer_randomizer) {
+		player->randomizer = malloc(sizeof(CitrusBagRandomizer));
+		CitrusBagRandomizer_init(player->randomizer, seed);
+	} else {
+		player->randomizer = malloc(sizeof(CitrusClassicRandomizer));
+		CitrusClassicRandomizer_init(player->randomizer, seed);
+	}
+	int size = config.full_height * config.width;
+	player->board = malloc(sizeof(CitrusCell) * size);
+	player->next_piece_queue = malloc(sizeof(CitrusPiece*) * config.next_piece_queue_size);
+	player->sent_board = malloc(sizeof(int) * size);
+	for (int i = 0; i < size; i++)
+		player->sent_board[i] = -1;
+	CitrusGame_init(&player->game, player->board, player->next_piece_queue, player_config, player->randomizer, player);
+	player->playing = true;
+	size_t start = message_begin(&player->output, MSG_CONFIG);
+	put_varint(&player->output, config.width);
+	put_varint(&player->output, config.full_height);
+	put_varint(&player->output, config.next_piece_queue_size);
+	put_varint(&player->output, player->number);
+	message_end(&player->output, start);
+}
+
+void join_room(Player* player, int id) {
+	Room* room = rooms;
+	while (room != NULL && room->id != id)
+		room = room->next;
+	if (room == NULL) {
+		room = calloc(1, sizeof(Room));
+		room->id = id;
+		room->next = rooms;
+		rooms = room;
+	}
+	for (int i = 0; i < ROOM_SIZE; i++) {
+		if (room->players[i] == NULL) {
+			room->players[i] = player;
+			player->room = room;
+			player->number = i;
+			player->attack_target = i;
+			start_game(player);
+			return;
+		}
+	}
+	// the room is full
+	size_t start = message_begin(&player->output, MSG_GAME_OVER);
+	message_end(&player->output, start);
+	player->finished = true;
+}
+
+void leave_room(Player* player) {
+	Room* room = player->room;
+	if (room == NULL)
+		return;
+	room->players[player->number] = NULL;
+	for (int i = 0; i < ROOM_SIZE; i++) {
+		if (room->players[i] != NULL)
+			return;
+	}
+	Room** p = &rooms;
+	while (*p != room)
+		p = &(*p)->next;
+	*p = room->next;
+	free(room);
+}
+
+void remove_player(Player* player) {
+	if (player->removed)
+		return;
+	epoll_ctl(epoll_fd, EPOLL_CTL_DEL, player->fd, NULL);
+	close(player->fd);
+	player->removed = true;
+	player->playing = false;
+	player->next_removed = removed_players;
+	removed_players = player;
+	n_players--;
+}
+
+void free_removed_players(void) {
+	while (removed_players != NULL) {
+		Player* player = removed_players;
+		removed_players = player->next_removed;
+		leave_room(player);
+		if (player->board != NULL) {
+			free(player->board);
+			free(player->next_piece_queue);
+			free(player->randomizer);
+			free(player->sent_board);
+		}
+		buffer_free(&player->input);
+		buffer_free(&player->output);
+		buffer_free(&player->sent_state);
+		free(player);
+	}
+}
+
+void flush_output(Player* player) {
+	while (player->output.size > 0) {
+		ssize_t n = send(player->fd, player->output.data, player->output.size, MSG_NOSIGNAL);
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if (n <= 0) {
+			remove_player(player);
+			return;
+		}
+		buffer_consume(&player->output, n);
+	}
+	if (player->output.size > MAX_OUTPUT) {
+		// too slow to keep up with its game
+		remove_player(player);
+		return;
+	}
+	bool writing = player->output.size > 0;
+	if (writing != player->writing) {
+		struct epoll_event event = {.events = EPOLLIN | (writing ? EPOLLOUT : 0), .data.ptr = player};
+		epoll_ctl(epoll_fd, EPOLL_CTL_MOD, player->fd, &event);
+		player->writing = writing;
+	}
+}
+
+void handle_message(Player* player, Message* message) {
+	if (message->type == MSG_JOIN && player->room == NULL) {
+		join_room(player, get_varint(message));
+	} else if (message->type == MSG_KEY && player->playing) {
+		int byte = get_byte(message);
+		int key = byte & 0x7f;
+		if (byte < 0 || !valid_key(key))
+			return;
+		// keys are applied straight away, so they take effect on the
+		// next tick
+		if (byte & 0x80)
+			CitrusGame_key_up(&player->game, key);
+		else
+			CitrusGame_key_down(&player->game, key);
+		if (!CitrusGame_is_alive(&player->game))
+			player->playing = false;
+	}
+}
+
+void read_input(Player* player) {
+	while (true) {
+		unsigned char buffer[4096];
+		ssize_t n = recv(player->fd, buffer, sizeof(buffer), 0);
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if (n <= 0) {
+			remove_player(player);
+			return;
+		}
+		buffer_append(&player->input, buffer, n);
+	}
+	size_t offset = 0;
+	Message message;
+	while (next_message(&player->input, &offset, &message))
+		handle_message(player, &message);
+	buffer_consume(&player->input, offset);
+	if (player->input.size > MAX_MESSAGE_SIZE)
+		remove_player(player);
+}
+
+void accept_players(void) {
+	while (true) {
+		int fd = accept(listen_fd, NULL, NULL);
+		if (fd < 0)
+			return;
+		set_nonblocking(fd);
+		int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+		Player* player = calloc(1, sizeof(Player));
+		player->fd = fd;
+		struct epoll_event event = {.events = EPOLLIN, .data.ptr = player};
+		epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+		n_players++;
+	}
+}
+
+int send_piece_id(const CitrusPiece* piece) {
+	return piece == NULL ? NO_PIECE : piece_id(piece);
+}
+
+// sends the changes to a player's game since the last time
+void send_updates(Player* player) {
+	Buffer* output = &player->output;
+	size_t start = 0;
+	int skip = 0;
+	for (int i = 0; i < config.full_height * config.width; i++) {
+		int color = cell_color(player->board[i]);
+		if (color == player->sent_board[i]) {
+			skip++;
+			continue;
+		}
+		if (start == 0)
+			start = message_begin(output, MSG_BOARD);
+		put_varint(output, skip);
+		put_byte(output, color);
+		player->sent_board[i] = color;
+		skip = 0;
+	}
+	if (start != 0)
+		message_end(output, start);
+	// the tick count changes every tick, so it is only sent along with
+	// other changes
+	Buffer state = {0};
+	put_byte(&state, send_piece_id(player->game.hold_piece));
+	for (int i = 0; i < config.next_piece_queue_size; i++)
+		put_byte(&state, send_piece_id(CitrusGame_get_next_piece(&player->game, i)));
+	put_varint(&state, player->game.score);
+	put_varint(&state, player->game.level);
+	put_varint(&state, player->game.lines);
+	put_varint(&state, player->pieces);
+	if (state.size != player->sent_state.size || memcmp(state.data, player->sent_state.data, state.size) != 0) {
+		start = message_begin(output, MSG_STATE);
+		buffer_append(output, state.data, state.size);
+		put_varint(output, player->ticks);
+		message_end(output, start);
+		buffer_free(&player->sent_state);
+		player->sent_state = state;
+	} else {
+		buffer_free(&state);
+	}
+}
+
+void tick_rooms(int n_ticks) {
+	for (Room* room = rooms; room != NULL; room = room->next) {
+		for (int i = 0; i < ROOM_SIZE; i++) {
+			Player* player = room->players[i];
+			if (player == NULL || !player->playing)
+				continue;
+			for (int j = 0; j < n_ticks && CitrusGame_is_alive(&player->game); j++) {
+				CitrusGame_tick(&player->game);
+				player->ticks++;
+			}
+		}
+	}
+	// games are only sent once every game in the room has been stepped,
+	// so that garbage from this tick goes out with them
+	for (Room* room = rooms; room != NULL; room = room->next) {
+		for (int i = 0; i < ROOM_SIZE; i++) {
+			Player* player = room->players[i];
+			if (player == NULL || player->removed || player->finished)
+				continue;
+			send_updates(player);
+			if (!CitrusGame_is_alive(&player->game)) {
+				size_t start = message_begin(&player->output, MSG_GAME_OVER);
+				message_end(&player->output, start);
+				player->playing = false;
+				player->finished = true;
+			}
+		}
+	}
+	for (Room* room = rooms; room != NULL; room = room->next) {
+		for (int i = 0; i < ROOM_SIZE; i++) {
+			Player* player = room->players[i];
+			if (player != NULL && !player->removed && player->output.size > 0)
+				flush_output(player);
+		}
+	}
+}
+
+int run_server(const char* address) {
+	listen_fd = net_listen(address);
+	if (listen_fd < 0) {
+		perror(address);
+		return -1;
+	}
+	set_nonblocking(listen_fd);
+	srand(time(NULL));
+	init_piece_table();
+	epoll_fd = epoll_create1(0);
+	timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+	long tick_ns = 1000000000L / tick_rate;
+	// at one tick a second, the tick is a whole second, which tv_nsec can't hold
+	struct timespec tick_length = {tick_ns / 1000000000L, tick_ns % 1000000000L};
+	struct itimerspec interval = {tick_length, tick_length};
+	if (timer_fd < 0 || timerfd_settime(timer_fd, 0, &interval, NULL) < 0) {
+		perror("timerfd");
+		return -1;
+	}
+	struct epoll_event event = {.events = EPOLLIN, .data.ptr = &listen_fd};
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+	event.data.ptr = &timer_fd;
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &event);
+	fprintf(stderr, "listening on %s\n", address);
+	double tick_time = 0;
+	int stats_ticks = 0;
+	double next_stats = now() + STATS_INTERVAL;
+	while (true) {
+		struct epoll_event events[MAX_EVENTS];
+		int n = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+		if (n < 0 && errno != EINTR) {
+			perror("epoll_wait");
+			return -1;
+		}
+		for (int i = 0; i < n; i++) {
+			void* ptr = events[i].data.ptr;
+			if (ptr == &listen_fd) {
+				accept_players();
+			} else if (ptr == &timer_fd) {
+				uint64_t expirations = 0;
+				if (read(timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+					continue;
+				if (expirations > MAX_CATCH_UP_TICKS)
+					expirations = MAX_CATCH_UP_TICKS;
+				double start = now();
+				tick_rooms(expirations);
+				tick_time += now() - start;
+				stats_ticks += expirations;
+			} else {
+				Player* player = ptr;
+				if (!player->removed && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+					read_input(player);
+				if (!player->removed && player->output.size > 0)
+					flush_output(player);
+			}
+		}
+		free_removed_players();
+		if (now() >= next_stats) {
+			fprintf(stderr, "%i players, %.1f us per tick\n", n_players, stats_ticks > 0 ? tick_time / stats_ticks * 1e6 : 0);
+			tick_time = 0;
+			stats_ticks = 0;
+			next_stats += STATS_INTERVAL;
+		}
+	}
+}
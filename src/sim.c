@@ -0,0 +1,182 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include "game.h"
+#include "sim.h"
+
+// Steps lots of games at once. Each worker thread owns a shard of the games,
+// which it allocates itself so that they end up in memory close to it.
+// Games don't affect each other, so a step of any number of ticks is split
+// into chunks of games. A worker first takes chunks from its own shard, then
+// steals chunks left over in other shards.
+
+#define CHUNK_SIZE 32
+
+typedef struct {
+	Sim* sim;
+	int worker;
+} SimWorker;
+
+void sim_action_text_callback(void* data, int n_lines_cleared, int combo, bool b2b, bool all_clear, bool spin, bool mini_spin) {
+	(void) mini_spin;
+	SimGame* game = data;
+	game->pieces++;
+	game->lines += n_lines_cleared;
+	game->attack += clear_attack(n_lines_cleared, combo, b2b, all_clear, spin);
+	game->last_clear = n_lines_cleared;
+}
+
+void start_sim_game(Sim* sim, SimGame* game) {
+	CitrusGameConfig game_config = sim->config;
+	game_config.action_text = sim_action_text_callback;
+	unsigned int seed = game->rng;
+	if (game_config.randomizer == CitrusBagRandomizer_randomizer)
+		CitrusBagRandomizer_init(&game->randomizer.bag, seed);
+	else
+		CitrusClassicRandomizer_init(&game->randomizer.classic, seed);
+	CitrusGame_init(&game->game, game->board, game->next_piece_queue, game_config, &game->randomizer, game);
+	game->pieces = 0;
+	game->ticks = 0;
+	game->lines = 0;
+	game->attack = 0;
+	game->last_clear = 0;
+}
+
+void init_shard(Sim* sim, int worker) {
+	SimShard* shard = &sim->shards[worker];
+	int first = (long long) sim->n_games * worker / sim->n_workers;
+	int last = (long long) sim->n_games * (worker + 1) / sim->n_workers;
+	int n = last - first;
+	size_t board_size = sizeof(CitrusCell) * sim->config.full_height * sim->config.width;
+	size_t queue_size = sizeof(CitrusPiece*) * sim->config.next_piece_queue_size;
+	char* arena = malloc(sizeof(SimGame) * n + (board_size + queue_size) * n);
+	shard->arena = arena;
+	shard->games = (SimGame*) arena;
+	shard->n_games = n;
+	char* boards = arena + sizeof(SimGame) * n;
+	char* queues = boards + board_size * n;
+	for (int i = 0; i < n; i++) {
+		SimGame* game = &shard->games[i];
+		game->board = (CitrusCell*) (boards + board_size * i);
+		game->next_piece_queue = (const CitrusPiece**) (queues + queue_size * i);
+		game->rng = (sim->seed + first + i) * 2654435761u | 1;
+		game->games = 0;
+		game->data = NULL;
+		start_sim_game(sim, game);
+	}
+}
+
+void run_chunk(Sim* sim, SimShard* shard, int chunk, int worker) {
+	int end = (chunk + 1) * CHUNK_SIZE;
+	if (end > shard->n_games)
+		end = shard->n_games;
+	for (int i = chunk * CHUNK_SIZE; i < end; i++) {
+		SimGame* game = &shard->games[i];
+		for (int j = 0; j < sim->step_ticks; j++) {
+			if (sim->policy != NULL)
+				sim->policy(game, worker);
+			if (CitrusGame_is_alive(&game->game)) {
+				CitrusGame_tick(&game->game);
+				game->ticks++;
+			}
+			bool finished = sim->max_pieces > 0 && game->pieces >= sim->max_pieces;
+			if (finished || !CitrusGame_is_alive(&game->game)) {
+				if (sim->game_over != NULL)
+					sim->game_over(game, worker);
+				game->games++;
+				start_sim_game(sim, game);
+			}
+		}
+	}
+}
+
+void* sim_worker_main(void* data) {
+	SimWorker* w = data;
+	Sim* sim = w->sim;
+	int worker = w->worker;
+	free(w);
+	init_shard(sim, worker);
+	pthread_barrier_wait(&sim->done);
+	while (true) {
+		pthread_barrier_wait(&sim->start);
+		if (sim->quit)
+			break;
+		double start = now();
+		for (int i = 0; i < sim->n_workers; i++) {
+			SimShard* shard = &sim->shards[(worker + i) % sim->n_workers];
+			int n_chunks = (shard->n_games + CHUNK_SIZE - 1) / CHUNK_SIZE;
+			int chunk;
+			while ((chunk = atomic_fetch_add(&shard->next_chunk, 1)) < n_chunks)
+				run_chunk(sim, shard, chunk, worker);
+		}
+		sim->shards[worker].busy_time += now() - start;
+		pthread_barrier_wait(&sim->done);
+	}
+	free(sim->shards[worker].arena);
+	return NULL;
+}
+
+void sim_init(Sim* sim, CitrusGameConfig config, int n_games, int n_workers, unsigned int seed, SimPolicy policy, SimGameOver game_over) {
+	sim->config = config;
+	sim->n_games = n_games;
+	sim->n_workers = n_workers;
+	sim->seed = seed;
+	sim->policy = policy;
+	sim->game_over = game_over;
+	sim->max_pieces = 0;
+	sim->quit = false;
+	sim->total_ticks = 0;
+	sim->step_time = 0;
+	sim->shards = calloc(n_workers, sizeof(SimShard));
+	sim->threads = malloc(sizeof(pthread_t) * n_workers);
+	pthread_barrier_init(&sim->start, NULL, n_workers + 1);
+	pthread_barrier_init(&sim->done, NULL, n_workers + 1);
+	for (int i = 0; i < n_workers; i++) {
+		SimWorker* w = malloc(sizeof(SimWorker));
+		w->sim = sim;
+		w->worker = i;
+		pthread_create(&sim->threads[i], NULL, sim_worker_main, w);
+	}
+	// wait for the workers to set up their games
+	pthread_barrier_wait(&sim->done);
+}
+
+// Runs every game for n_ticks ticks.
+void sim_step(Sim* sim, int n_ticks) {
+	double start = now();
+	sim->step_ticks = n_ticks;
+	for (int i = 0; i < sim->n_workers; i++)
+		atomic_store(&sim->shards[i].next_chunk, 0);
+	pthread_barrier_wait(&sim->start);
+	pthread_barrier_wait(&sim->done);
+	sim->total_ticks += n_ticks;
+	sim->step_time += now() - start;
+}
+
+void sim_free(Sim* sim) {
+	sim->quit = true;
+	pthread_barrier_wait(&sim->start);
+	for (int i = 0; i < sim->n_workers; i++)
+		pthread_join(sim->threads[i], NULL);
+	pthread_barrier_destroy(&sim->start);
+	pthread_barrier_destroy(&sim->done);
+	free(sim->shards);
+	free(sim->threads);
+}
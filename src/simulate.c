@@ -0,0 +1,316 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bitboard.h"
+#include "bot.h"
+#include "game.h"
+#include "sim.h"
+
+// Plays lots of games with a bot on every core, to see how a config plays
+// out. Every game slot plays the same number of games, so that long games
+// aren't undercounted by stopping when enough games have finished.
+
+#define STEP_TICKS 600
+
+// what the bot knows about one game
+typedef struct {
+	int games;
+	int current;
+	int tracked_pieces;
+	const CitrusPiece* tracked_next;
+	int act_tick;
+} BotGame;
+
+// Each worker adds up its own games, and these are only merged at the end,
+// so workers never write to the same memory.
+typedef struct {
+	long long games;
+	long long deaths;
+	long long ticks;
+	long long pieces;
+	long long lines;
+	long long attack;
+	long long slots_done;
+	long long piece_counts[N_PIECES];
+	// how many games lasted each number of pieces
+	long long* survival;
+	// keep workers' stats apart
+	char padding[64];
+} Stats;
+
+const char* program_name;
+long long n_games = 100000;
+int n_threads = 0;
+int max_pieces = 1000;
+unsigned int seed = 1;
+int games_per_slot;
+Stats* stats;
+
+int string_to_int(const char* s, int minimum) {
+	char* endptr;
+	int i = strtol(s, &endptr, 10);
+	if (endptr == s || *endptr != '\0') {
+		fprintf(stderr, "%s: invalid number %s\n", program_name, s);
+		exit(-1);
+	}
+	if (i < minimum) {
+		fprintf(stderr, "%s: %i is too small\n", program_name, i);
+		exit(-1);
+	}
+	return i;
+}
+
+void press(CitrusGame* game, CitrusKey key) {
+	CitrusGame_key_down(game, key);
+	CitrusGame_key_up(game, key);
+}
+
+// Drops the falling piece where the bot wants it. libcitrus doesn't say
+// where the falling piece is, but it has only just spawned, so its cells are
+// the highest ones of its color.
+void play_piece(SimGame* game, int piece) {
+	Bitboard bitboard;
+	bitboard_from_cells(&bitboard, game->board, config.width, config.full_height);
+	int removed = 0;
+	for (int y = config.full_height - 1; y >= 0 && removed < 4; y--) {
+		for (int x = 0; x < config.width && removed < 4; x++) {
+			CitrusCell cell = game->board[y * config.width + x];
+			if (cell.type == CITRUS_CELL_FULL && (int) cell.color == piece) {
+				bitboard.rows[y] &= ~((uint64_t) 1 << x);
+				removed++;
+			}
+		}
+	}
+	Placement best;
+	if (bot_best_drop(&bitboard, piece, config.height, &best)) {
+		if (best.rotation == 1)
+			press(&game->game, CITRUS_KEY_CLOCKWISE);
+		else if (best.rotation == 2)
+			press(&game->game, CITRUS_KEY_180);
+		else if (best.rotation == 3)
+			press(&game->game, CITRUS_KEY_ANTICLOCKWISE);
+		int shift = placement_shift(&best, config.width);
+		for (int i = 0; i < abs(shift); i++)
+			press(&game->game, shift < 0 ? CITRUS_KEY_LEFT : CITRUS_KEY_RIGHT);
+	}
+	press(&game->game, CITRUS_KEY_HARD_DROP);
+}
+
+void bot_policy(SimGame* game, int worker) {
+	BotGame* player = game->data;
+	if (player == NULL) {
+		player = calloc(1, sizeof(BotGame));
+		player->games = -1;
+		game->data = player;
+	}
+	if (game->games >= games_per_slot)
+		return;
+	if (player->games != game->games) {
+		// a new game, where the only full cells are the falling piece's
+		player->games = game->games;
+		player->current = -1;
+		for (int i = 0; i < config.width * config.full_height; i++) {
+			if (game->board[i].type == CITRUS_CELL_FULL)
+				player->current = game->board[i].color;
+		}
+		player->tracked_pieces = 0;
+		player->act_tick = 0;
+	} else if (game->pieces != player->tracked_pieces) {
+		// the piece at the front of the queue has started falling,
+		// after the cleared lines have gone
+		player->current = piece_id(player->tracked_next);
+		player->tracked_pieces = game->pieces;
+		player->act_tick = game->ticks + (game->last_clear > 0 ? config.line_clear_delay : 0);
+	}
+	player->tracked_next = CitrusGame_get_next_piece(&game->game, 0);
+	if (player->act_tick >= 0 && game->ticks >= player->act_tick && player->current != -1) {
+		stats[worker].piece_counts[player->current]++;
+		play_piece(game, player->current);
+		player->act_tick = -1;
+	}
+}
+
+void record_game(SimGame* game, int worker) {
+	if (game->games >= games_per_slot)
+		return;
+	Stats* s = &stats[worker];
+	s->games++;
+	s->deaths += !CitrusGame_is_alive(&game->game);
+	s->ticks += game->ticks;
+	s->pieces += game->pieces;
+	s->lines += game->lines;
+	s->attack += game->attack;
+	s->survival[game->pieces < max_pieces ? game->pieces : max_pieces]++;
+	if (game->games + 1 == games_per_slot)
+		s->slots_done++;
+}
+
+// the number of pieces that fraction p of the games lasted at most
+int survival_percentile(const long long* survival, long long games, double p) {
+	long long target = games * p;
+	long long count = 0;
+	for (int i = 0; i <= max_pieces; i++) {
+		count += survival[i];
+		if (count > target)
+			return i;
+	}
+	return max_pieces;
+}
+
+int main(int argc, char** argv) {
+	program_name = argv[0];
+	config = citrus_preset_modern;
+	int c;
+	while ((c = getopt(argc, argv, "cDd:f:g:h:j:L:l:m:n:p:q:r:s:w:")) != -1) {
+		switch (c) {
+			case 'w':
+				config.width = string_to_int(optarg, 4);
+				break;
+			case 'h':
+				config.height = string_to_int(optarg, -1);
+				break;
+			case 'f':
+				config.full_height = string_to_int(optarg, 3);
+				break;
+			case 'g':
+				config.gravity = 1.0 / 60.0 * string_to_int(optarg, 0);
+				break;
+			case 'l':
+				config.lock_delay = string_to_int(optarg, 1);
+				break;
+			case 'm':
+				config.max_move_reset = string_to_int(optarg, 0);
+				break;
+			case 'q':
+				config.next_piece_queue_size = string_to_int(optarg, 1);
+				break;
+			case 'L':
+				config.line_clear_delay = string_to_int(optarg, 0);
+				break;
+			case 'c':
+				config = citrus_preset_classic;
+				break;
+			case 'D':
+				config = citrus_preset_delayless;
+				break;
+			case 'r':
+				if (strcmp(optarg, "bag") == 0) {
+					config.randomizer = CitrusBagRandomizer_randomizer;
+				} else if (strcmp(optarg, "classic") == 0) {
+					config.randomizer = CitrusClassicRandomizer_randomizer;
+				} else {
+					fprintf(stderr, "%s: unknown randomizer %s\n", program_name, optarg);
+					exit(-1);
+				}
+				break;
+			case 'n':
+				n_games = string_to_int(optarg, 1);
+				break;
+			case 'j':
+				n_threads = string_to_int(optarg, 1);
+				break;
+			case 'p':
+				max_pieces = string_to_int(optarg, 1);
+				break;
+			case 's':
+				seed = strtoul(optarg, NULL, 10);
+				break;
+			case '?':
+				exit(-1);
+			default:
+				break;
+		}
+	}
+	if (config.full_height == 40) {
+		int extra_height = config.height;
+		if (extra_height < 4)
+			extra_height = 4;
+		if (extra_height > 20)
+			extra_height = 20;
+		config.full_height = config.height + extra_height;
+	}
+	if (config.width > BITBOARD_MAX_WIDTH || config.full_height > BITBOARD_MAX_HEIGHT) {
+		fprintf(stderr, "%s: board must be at most %ix%i\n", program_name, BITBOARD_MAX_WIDTH, BITBOARD_MAX_HEIGHT);
+		exit(-1);
+	}
+	if (n_threads == 0)
+		n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+	init_piece_table();
+	init_piece_shapes();
+	// enough games at once to keep every thread busy, each playing its
+	// share of the games
+	int slots = n_games < n_threads * 256 ? n_games : n_threads * 256;
+	games_per_slot = (n_games + slots - 1) / slots;
+	stats = calloc(n_threads, sizeof(Stats));
+	for (int i = 0; i < n_threads; i++)
+		stats[i].survival = calloc(max_pieces + 1, sizeof(long long));
+	Sim sim;
+	sim_init(&sim, config, slots, n_threads, seed, bot_policy, record_game);
+	sim.max_pieces = max_pieces;
+	long long slots_done = 0;
+	while (slots_done < slots) {
+		sim_step(&sim, STEP_TICKS);
+		slots_done = 0;
+		for (int i = 0; i < n_threads; i++)
+			slots_done += stats[i].slots_done;
+	}
+	for (int i = 0; i < n_threads; i++) {
+		for (int j = 0; j < sim.shards[i].n_games; j++)
+			free(sim.shards[i].games[j].data);
+	}
+	Stats total = {0};
+	total.survival = calloc(max_pieces + 1, sizeof(long long));
+	for (int i = 0; i < n_threads; i++) {
+		total.games += stats[i].games;
+		total.deaths += stats[i].deaths;
+		total.ticks += stats[i].ticks;
+		total.pieces += stats[i].pieces;
+		total.lines += stats[i].lines;
+		total.attack += stats[i].attack;
+		for (int j = 0; j < N_PIECES; j++)
+			total.piece_counts[j] += stats[i].piece_counts[j];
+		for (int j = 0; j <= max_pieces; j++)
+			total.survival[j] += stats[i].survival[j];
+		free(stats[i].survival);
+	}
+	printf("%lld games on %i threads in %.1f s (%.0f games/s, %.0f ticks/s)\n", total.games, n_threads,
+		sim.step_time, total.games / sim.step_time, (double) sim.total_ticks * slots / sim.step_time);
+	printf("died      %5.1f%% (the rest reached %i pieces)\n", 100.0 * total.deaths / total.games, max_pieces);
+	printf("pieces    %.1f per game, %i / %i / %i at 10%% / 50%% / 90%%\n", (double) total.pieces / total.games,
+		survival_percentile(total.survival, total.games, 0.1), survival_percentile(total.survival, total.games, 0.5),
+		survival_percentile(total.survival, total.games, 0.9));
+	printf("ticks     %.1f per game\n", (double) total.ticks / total.games);
+	printf("lines     %.1f per game, %.3f per piece\n", (double) total.lines / total.games, (double) total.lines / total.pieces);
+	printf("attack    %.1f per game, %.3f per piece\n", (double) total.attack / total.games, (double) total.attack / total.pieces);
+	long long dealt = 0;
+	for (int i = 0; i < N_PIECES; i++)
+		dealt += total.piece_counts[i];
+	printf("pieces   ");
+	for (int i = 0; i < N_PIECES; i++)
+		printf(" %c %.1f%%", "IJLOSTZ"[i], 100.0 * total.piece_counts[i] / dealt);
+	printf("\n");
+	sim_free(&sim);
+	free(total.survival);
+	free(stats);
+	return 0;
+}
@@ -0,0 +1,406 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game.h"
+#include "replay.h"
+#include "snapshot.h"
+
+// The rewind buffer keeps the state after every tick in a fixed amount of
+// memory. Every few ticks the whole snapshot is stored as a keyframe, and
+// the ticks in between are stored as the XOR with their keyframe, run
+// length encoded. Most of the state doesn't change between two ticks, so
+// these deltas are mostly runs of zeros, and any tick can be restored from
+// its keyframe and one delta.
+//
+// The snapshots are stored one after another in a ring of bytes. When it
+// runs out of room the oldest keyframe is dropped along with its deltas, so
+// how far back the buffer goes depends on how well the game compresses.
+
+// zero runs shorter than this are cheaper to store as part of a literal
+#define MIN_ZERO_RUN 8
+
+typedef struct {
+	size_t offset;
+	size_t length;
+	long long keyframe;
+} Entry;
+
+// snapshot layout
+size_t randomizer_size;
+size_t board_size;
+size_t queue_size;
+size_t state_size;
+
+unsigned char* rewind_ring = NULL;
+size_t rewind_ring_size;
+Entry* rewind_entries;
+int max_entries;
+// entries are numbered from the start of the game, and entry i is stored in
+// rewind_entries[i % max_entries]
+long long first_entry;
+long long next_entry;
+int rewind_keyframe_interval;
+unsigned char* current_state;
+unsigned char* delta_buffer;
+
+// where the game is saved while it is run ahead
+unsigned char* lookahead_state = NULL;
+CitrusCell* lookahead_board = NULL;
+
+size_t snapshot_size(void) {
+	if (config.randomizer == CitrusBagRandomizer_randomizer)
+		randomizer_size = sizeof(CitrusBagRandomizer);
+	else
+		randomizer_size = sizeof(CitrusClassicRandomizer);
+	board_size = sizeof(CitrusCell) * config.width * config.full_height;
+	queue_size = sizeof(CitrusPiece*) * config.next_piece_queue_size;
+	state_size = sizeof(CitrusGame) + randomizer_size + board_size + queue_size
+		+ sizeof(pieces) + sizeof(ticks) + sizeof(attack) + sizeof(ReplayCursor);
+	return state_size;
+}
+
+void snapshot_save(unsigned char* buffer) {
+	ReplayCursor cursor;
+	replay_get_cursor(&cursor);
+	memcpy(buffer, &game, sizeof(CitrusGame));
+	buffer += sizeof(CitrusGame);
+	memcpy(buffer, randomizer, randomizer_size);
+	buffer += randomizer_size;
+	memcpy(buffer, board, board_size);
+	buffer += board_size;
+	memcpy(buffer, next_piece_queue, queue_size);
+	buffer += queue_size;
+	memcpy(buffer, &pieces, sizeof(pieces));
+	buffer += sizeof(pieces);
+	memcpy(buffer, &ticks, sizeof(ticks));
+	buffer += sizeof(ticks);
+	memcpy(buffer, &attack, sizeof(attack));
+	buffer += sizeof(attack);
+	memcpy(buffer, &cursor, sizeof(cursor));
+}
+
+void snapshot_load(const unsigned char* buffer) {
+	ReplayCursor cursor;
+	memcpy(&game, buffer, sizeof(CitrusGame));
+	buffer += sizeof(CitrusGame);
+	memcpy(randomizer, buffer, randomizer_size);
+	buffer += randomizer_size;
+	memcpy(board, buffer, board_size);
+	buffer += board_size;
+	memcpy(next_piece_queue, buffer, queue_size);
+	buffer += queue_size;
+	memcpy(&pieces, buffer, sizeof(pieces));
+	buffer += sizeof(pieces);
+	memcpy(&ticks, buffer, sizeof(ticks));
+	buffer += sizeof(ticks);
+	memcpy(&attack, buffer, sizeof(attack));
+	buffer += sizeof(attack);
+	memcpy(&cursor, buffer, sizeof(cursor));
+	replay_set_cursor(&cursor);
+}
+
+bool lookahead_start(void) {
+	lookahead_state = malloc(snapshot_size());
+	lookahead_board = malloc(board_size);
+	if (lookahead_state == NULL || lookahead_board == NULL) {
+		lookahead_stop();
+		return false;
+	}
+	return true;
+}
+
+// Runs the game ahead on a snapshot to find how many ticks from now
+// something on screen changes if no keys are pressed, up to limit. This
+// covers gravity, lock delay, line clear delay and auto repeat alike,
+// without knowing how libcitrus does them. PPS is left out, since it
+// changes all the time. The game is left exactly as it was, so running
+// this between any two ticks doesn't change how the game plays out.
+int ticks_until_change(int limit) {
+	View view;
+	get_game_view(&view);
+	memcpy(lookahead_board, board, board_size);
+	snapshot_save(lookahead_state);
+	show_action_text = false;
+	int n;
+	for (n = 1; n < limit; n++) {
+		CitrusGame_tick(&game);
+		ticks++;
+		if (!CitrusGame_is_alive(&game) || game.hold_piece != view.hold_piece || pieces != view.pieces
+			|| game.score != view.score || game.level != view.level || game.lines != view.lines
+			|| memcmp(board, lookahead_board, board_size) != 0)
+			break;
+	}
+	show_action_text = true;
+	snapshot_load(lookahead_state);
+	return n;
+}
+
+// libcitrus doesn't say which piece is falling, so this finds out on a
+// snapshot: hard dropping locks a piece if one is falling, and holding it
+// puts it in the hold slot. Returns -1 if nothing is falling, like while
+// lines are being cleared. Holding has to be allowed, so the piece can't
+// have come out of hold itself.
+int falling_piece(void) {
+	snapshot_save(lookahead_state);
+	show_action_text = false;
+	int before = pieces;
+	CitrusGame_key_down(&game, CITRUS_KEY_HARD_DROP);
+	CitrusGame_key_up(&game, CITRUS_KEY_HARD_DROP);
+	int piece = -1;
+	if (pieces != before) {
+		snapshot_load(lookahead_state);
+		CitrusGame_key_down(&game, CITRUS_KEY_HOLD);
+		CitrusGame_key_up(&game, CITRUS_KEY_HOLD);
+		if (game.hold_piece != NULL)
+			piece = piece_id(game.hold_piece);
+	}
+	show_action_text = true;
+	snapshot_load(lookahead_state);
+	return piece;
+}
+
+void lookahead_stop(void) {
+	free(lookahead_state);
+	free(lookahead_board);
+	lookahead_state = NULL;
+	lookahead_board = NULL;
+}
+
+size_t put_length(unsigned char* out, size_t value) {
+	size_t n = 0;
+	while (value >= 0x80) {
+		out[n++] = (value & 0x7f) | 0x80;
+		value >>= 7;
+	}
+	out[n++] = value;
+	return n;
+}
+
+size_t get_length(const unsigned char* in, size_t* value) {
+	size_t n = 0;
+	*value = 0;
+	for (int shift = 0;; shift += 7) {
+		unsigned char c = in[n++];
+		*value |= (size_t) (c & 0x7f) << shift;
+		if ((c & 0x80) == 0)
+			return n;
+	}
+}
+
+// length of the run of equal bytes starting at i, compared a word at a time
+size_t equal_run(const unsigned char* a, const unsigned char* b, size_t i, size_t size) {
+	size_t start = i;
+	while (i + 8 <= size) {
+		uint64_t x, y;
+		memcpy(&x, a + i, 8);
+		memcpy(&y, b + i, 8);
+		if (x != y)
+			return i - start + __builtin_ctzll(x ^ y) / 8;
+		i += 8;
+	}
+	while (i < size && a[i] == b[i])
+		i++;
+	return i - start;
+}
+
+// Encodes the XOR of state with base as pairs of a zero run and a literal
+// run, and returns the encoded size, or 0 if it isn't worth storing as a
+// delta.
+size_t encode_delta(const unsigned char* state, const unsigned char* base, unsigned char* out) {
+	size_t size = 0;
+	size_t i = 0;
+	while (i < state_size) {
+		size_t zeros = equal_run(state, base, i, state_size);
+		size_t literal_start = i + zeros;
+		size_t literal_end = literal_start;
+		while (literal_end < state_size) {
+			size_t run = equal_run(state, base, literal_end, state_size);
+			if (run >= MIN_ZERO_RUN || literal_end + run == state_size)
+				break;
+			literal_end += run + 1;
+		}
+		size_t literal = literal_end - literal_start;
+		if (size + literal + 20 > state_size / 2)
+			return 0;
+		size += put_length(out + size, zeros);
+		size += put_length(out + size, literal);
+		for (size_t j = literal_start; j < literal_end; j++)
+			out[size++] = state[j] ^ base[j];
+		i = literal_end;
+	}
+	return size;
+}
+
+void apply_delta(unsigned char* state, const unsigned char* in, size_t length) {
+	size_t i = 0;
+	size_t n = 0;
+	while (n < length) {
+		size_t zeros, literal;
+		n += get_length(in + n, &zeros);
+		n += get_length(in + n, &literal);
+		i += zeros;
+		for (size_t j = 0; j < literal; j++)
+			state[i++] ^= in[n++];
+	}
+}
+
+Entry* rewind_entry(long long i) {
+	return &rewind_entries[i % max_entries];
+}
+
+// drops the oldest keyframe and the deltas that depend on it
+void drop_oldest_keyframe(void) {
+	first_entry++;
+	while (first_entry < next_entry && rewind_entry(first_entry)->keyframe != first_entry)
+		first_entry++;
+}
+
+// Finds room for length bytes after the newest entry, dropping old entries
+// if needed. Returns false if that would drop the keyframe numbered keep,
+// which the new entry is a delta of.
+bool rewind_allocate(size_t length, long long keep, size_t* offset) {
+	if (length > rewind_ring_size)
+		return false;
+	if (next_entry - first_entry == max_entries) {
+		if (rewind_entry(first_entry)->keyframe == keep)
+			return false;
+		drop_oldest_keyframe();
+	}
+	while (first_entry < next_entry) {
+		const Entry* oldest = rewind_entry(first_entry);
+		const Entry* newest = rewind_entry(next_entry - 1);
+		size_t head = newest->offset + newest->length;
+		if (newest->offset >= oldest->offset) {
+			// the used bytes don't wrap around the end of the ring
+			if (rewind_ring_size - head >= length) {
+				*offset = head;
+				return true;
+			}
+			if (oldest->offset >= length) {
+				*offset = 0;
+				return true;
+			}
+		} else if (oldest->offset - head >= length) {
+			*offset = head;
+			return true;
+		}
+		if (oldest->keyframe == keep)
+			return false;
+		drop_oldest_keyframe();
+	}
+	*offset = 0;
+	return true;
+}
+
+bool rewind_start(int max_ticks, size_t memory, int interval) {
+	snapshot_size();
+	max_entries = max_ticks + 1;
+	rewind_ring_size = memory;
+	rewind_keyframe_interval = interval;
+	rewind_ring = malloc(rewind_ring_size);
+	rewind_entries = malloc(sizeof(Entry) * max_entries);
+	current_state = malloc(state_size);
+	delta_buffer = malloc(state_size);
+	first_entry = 0;
+	next_entry = 0;
+	if (rewind_ring == NULL || rewind_entries == NULL || current_state == NULL || delta_buffer == NULL) {
+		rewind_stop();
+		return false;
+	}
+	return true;
+}
+
+// Stores the state after a tick.
+void rewind_push(void) {
+	if (rewind_ring == NULL)
+		return;
+	snapshot_save(current_state);
+	size_t offset;
+	if (first_entry < next_entry) {
+		long long keyframe = rewind_entry(next_entry - 1)->keyframe;
+		if (next_entry - keyframe < rewind_keyframe_interval) {
+			size_t length = encode_delta(current_state, rewind_ring + rewind_entry(keyframe)->offset, delta_buffer);
+			if (length > 0 && rewind_allocate(length, keyframe, &offset)) {
+				memcpy(rewind_ring + offset, delta_buffer, length);
+				*rewind_entry(next_entry) = (Entry) {offset, length, keyframe};
+				next_entry++;
+				return;
+			}
+		}
+	}
+	if (!rewind_allocate(state_size, -1, &offset)) {
+		// the ring is too small for even one keyframe
+		first_entry = next_entry;
+		return;
+	}
+	memcpy(rewind_ring + offset, current_state, state_size);
+	*rewind_entry(next_entry) = (Entry) {offset, state_size, next_entry};
+	next_entry++;
+}
+
+// how many ticks back the buffer goes
+int rewind_available(void) {
+	if (first_entry == next_entry)
+		return 0;
+	return next_entry - 1 - first_entry;
+}
+
+// Goes back up to n_ticks ticks, forgetting the ticks after that, and
+// returns how many ticks it went back.
+int rewind_back(int n_ticks) {
+	if (rewind_ring == NULL || n_ticks <= 0)
+		return 0;
+	if (n_ticks > rewind_available())
+		n_ticks = rewind_available();
+	long long target = next_entry - 1 - n_ticks;
+	const Entry* e = rewind_entry(target);
+	memcpy(current_state, rewind_ring + rewind_entry(e->keyframe)->offset, state_size);
+	if (e->keyframe != target)
+		apply_delta(current_state, rewind_ring + e->offset, e->length);
+	snapshot_load(current_state);
+	invalidate_frame();
+	next_entry = target + 1;
+	return n_ticks;
+}
+
+size_t rewind_memory_used(void) {
+	if (first_entry == next_entry)
+		return 0;
+	const Entry* oldest = rewind_entry(first_entry);
+	const Entry* newest = rewind_entry(next_entry - 1);
+	if (newest->offset >= oldest->offset)
+		return newest->offset + newest->length - oldest->offset;
+	return rewind_ring_size - oldest->offset + newest->offset + newest->length;
+}
+
+void rewind_stop(void) {
+	free(rewind_ring);
+	free(rewind_entries);
+	free(current_state);
+	free(delta_buffer);
+	rewind_ring = NULL;
+	rewind_entries = NULL;
+	current_state = NULL;
+	delta_buffer = NULL;
+	first_entry = 0;
+	next_entry = 0;
+}
@@ -17,16 +17,29 @@
  * <https://www.gnu.org/licenses/>.
  */
 
-#include <stdarg.h>
+#include <getopt.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
-#include "backend.h"
-#include "citrus.h"
-
-Backend backend;
+#include "bitboard.h"
+#include "client.h"
+#include "finesse.h"
+#include "game.h"
+#include "input.h"
+#include "leaderboard.h"
+#include "profile.h"
+#include "render.h"
+#include "replay.h"
+#include "snapshot.h"
+#include "versus.h"
+#ifdef SERVER
+#include "broadcast.h"
+#include "host.h"
+#include "server.h"
+#endif
 
 #ifdef NCURSES_BACKEND
 #define DEFAULT_BACKEND ncurses_backend
@@ -39,24 +52,73 @@ extern Backend ncurses_backend;
 #endif
 extern Backend sdl3_backend;
 extern const char* font_path;
+extern bool vsync;
+#endif
+
+#ifdef ANSI_BACKEND
+#ifndef DEFAULT_BACKEND
+#define DEFAULT_BACKEND ansi_backend
+#endif
+extern Backend ansi_backend;
 #endif
 
 #ifndef DEFAULT_BACKEND
 #error "no backend selected"
 #endif
 
+#define MAX_CATCH_UP_TICKS 4
+#define MAX_FINESSE_KEYS 16
+#define REWIND_SECONDS 600
+#define REWIND_MEMORY (32 << 20)
+#define KEYFRAME_INTERVAL 60
+#define LEADERBOARD_ROWS 10
+
 const char* program_name;
-const CitrusPiece** next_piece_queue;
-CitrusGameConfig config;
-CitrusCell* board;
-CitrusGame game;
-void* randomizer;
-Window board_win, next_piece_win, hold_win;
 bool one_key_finesse = false;
-int pieces = 0;
-int ticks = 0;
+int render_rate = 60;
+int preset = 0;
+const char* record_path = NULL;
+const char* replay_path = NULL;
+bool headless = false;
+bool verify = false;
+bool practice = false;
+bool rewinding = false;
+bool can_lookahead = false;
+const char* server_address = NULL;
+const char* host_address = NULL;
+const char* connect_address = NULL;
+const char* watch_address = NULL;
+const char* broadcast_address = NULL;
+const char* trace_path = NULL;
+const char* leaderboard_path = NULL;
+const char* player_name = NULL;
+bool list_scores = false;
+int room = 0;
 
-const char* clear_names[5] = {"", "Single", "Double", "Triple", "Quad"};
+const struct option long_options[] = {
+	{"record", required_argument, NULL, 'o'},
+	{"replay", required_argument, NULL, 'R'},
+	{"headless", no_argument, NULL, 'H'},
+	{"verify", no_argument, NULL, 'v'},
+	{"server", required_argument, NULL, 'X'},
+	{"host", required_argument, NULL, 'Y'},
+	{"connect", required_argument, NULL, 'C'},
+	{"room", required_argument, NULL, 'N'},
+	{"watch", required_argument, NULL, 'W'},
+	{"broadcast", required_argument, NULL, 'B'},
+	{"ansi", no_argument, NULL, 'A'},
+	{"stats", no_argument, NULL, 'P'},
+	{"minimap", no_argument, NULL, 'M'},
+	{"trace", required_argument, NULL, 'T'},
+	{"practice", no_argument, NULL, 'p'},
+	{"leaderboard", required_argument, NULL, 'b'},
+	{"name", required_argument, NULL, 'n'},
+	{"scores", no_argument, NULL, 'k'},
+	{"versus", no_argument, NULL, 'y'},
+	{"bot-pps", required_argument, NULL, 'u'},
+	{"bot-budget", required_argument, NULL, 'U'},
+	{NULL, 0, NULL, 0},
+};
 
 const char* rows[4] = {
 	"asdfghjkl;",
@@ -65,90 +127,136 @@ const char* rows[4] = {
 	"qwertyuiop",
 };
 
-void update_window(Window win, const CitrusCell* data, int height, int width, int y_offset, int x_offset) {
-	for (int y = 0; y < height; y++) {
-		for (int x = 0; x < width; x++) {
-			CitrusCell cell = data[y * width + x];
-			int color;
-			if (cell.type == CITRUS_CELL_FULL)
-				color = cell.color + 2;
-			else if (cell.type == CITRUS_CELL_SHADOW)
-				color = 1;
-			else
-				color = 0;
-			backend.draw_cell(win, x * 2 + x_offset + 1, height - y + y_offset, color);
-		}
+// rotation * KEY_COLUMNS + column for each key, or -1
+int keymap[256];
+// keys waiting for the piece before them to drop
+int finesse_keys[MAX_FINESSE_KEYS];
+int first_finesse_key = 0;
+int n_finesse_keys = 0;
+// the move being played, which is waiting for a held key when hold_left
+// isn't 0
+const FinesseMove* finesse_move = NULL;
+int finesse_step;
+int hold_left = 0;
+// The piece that came out of hold, which can't be found by holding it
+// again. It is the falling piece until another one locks.
+int held_piece;
+int held_at = -1;
+
+void init_keymap(void) {
+	for (int i = 0; i < 256; i++)
+		keymap[i] = -1;
+	for (int rotation = 0; rotation < 4; rotation++) {
+		for (int column = 0; column < KEY_COLUMNS; column++)
+			keymap[(unsigned char) rows[rotation][column]] = rotation * KEY_COLUMNS + column;
 	}
-	backend.draw_box(win);
-	backend.update(win);
 }
 
-void print_action_text(const char* fmt, ...) {
-	char buffer[512];
-	va_list args;
-	va_start(args, fmt);
-	vsnprintf(buffer, sizeof(buffer), fmt, args);
-	va_end(args);
-	backend.erase_line(0, 2);
-	int x = board_win.x + (board_win.width - strlen(buffer)) / 4;
-	backend.print(2, x, buffer);
-	backend.full_update();
+void get_view(View* view) {
+	if (client_connected())
+		client_get_view(view);
+	else
+		get_game_view(view);
 }
 
-void update(void) {
-	backend.erase_window(board_win);
-	backend.erase_window(hold_win);
-	backend.erase_window(next_piece_win);
-	update_window(board_win, board, config.full_height, config.width, 0, 0);
-	if (game.hold_piece == NULL) {
-		update_window(hold_win, NULL, 0, 0, 0, 0);
-	} else {
-		const CitrusCell* data = game.hold_piece->piece_data;
-		int height = game.hold_piece->height;
-		int width = game.hold_piece->width;
-		update_window(hold_win, data, height, width, height >= 4 ? 0 : 1, 4 - height);
-	}
-	for (int i = 0; i < config.next_piece_queue_size; i++) {
-		const CitrusPiece* piece = CitrusGame_get_next_piece(&game, i);
-		const CitrusCell* data = piece->piece_data;
-		int height = piece->height;
-		int width = piece->width;
-		update_window(next_piece_win, data, height, width, (height >= 4 ? 0 : 1) + i * 4, 4 - height);
-	}
-	backend.print(hold_win.y + hold_win.height + 1, hold_win.x, "Score: %i", game.score);
-	backend.print(hold_win.y + hold_win.height + 2, hold_win.x, "Level: %i", game.level);
-	backend.print(hold_win.y + hold_win.height + 3, hold_win.x, "Lines: %i", game.lines);
-	backend.print(hold_win.y + hold_win.height + 4, hold_win.x, "  PPS: %.2f", ((float)pieces)/((float)ticks/60.0));
-	backend.full_update();
+// keys go to the server when connected, and are recorded otherwise
+bool send_key(CitrusKey key, bool up) {
+	if (client_connected()) {
+		client_send_key(key, up);
+		return true;
+	}
+	replay_record_key(key, up);
+	return false;
 }
 
-void action_text_callback(void* data, int n_lines_cleared, int combo, bool b2b, bool all_clear, bool spin, bool mini_spin) {
-	pieces++;
-	(void) data;
-	if (n_lines_cleared == 0 && !spin && !mini_spin) {
-		return;
-	}
-	const char* name = clear_names[n_lines_cleared];
-	char combo_text[512] = "";
-	if (combo > 0) {
-		snprintf(combo_text, sizeof(combo_text), " Combo %i", combo);
+// the stats overlay, over the last second
+bool draw_stats(int line) {
+	bool changed = false;
+	for (int i = 0; i < N_PHASES; i++) {
+		PhaseStats stats;
+		profile_get_stats(i, true, &stats);
+		changed |= update_hud_line(line + i, "%-6s p50 %4.0f p99 %4.0f max %5.0f us", phase_names[i], stats.p50, stats.p99, stats.max);
 	}
-	print_action_text("%s%s%s%s%s", all_clear ? "All Clear " : "", b2b ? "B2B " : "", spin ? "T Spin " : mini_spin ? "Mini T Spin " : "", name, combo_text);
+	return changed;
 }
 
-void init_citrus() {
-	srand(time(NULL));
-	config.action_text = action_text_callback;
-	if (config.randomizer == CitrusBagRandomizer_randomizer) {
-		randomizer = malloc(sizeof(CitrusBagRandomizer));
-		CitrusBagRandomizer_init(randomizer, rand());
-	} else {
-		randomizer = malloc(sizeof(CitrusClassicRandomizer));
-		CitrusClassicRandomizer_init(randomizer, rand());
+void record_flush(double start, double end) {
+	profile_record(PHASE_FLUSH, start, end);
+}
+
+// sends what is on screen to spectators
+void broadcast(void) {
+#ifdef SERVER
+	View view;
+	get_view(&view);
+	broadcast_frame(&view);
+#endif
+}
+
+void press(CitrusKey key) {
+	game_key_down(key);
+	game_key_up(key);
+}
+
+int current_piece(void) {
+	if (pieces == held_at)
+		return held_piece;
+	return falling_piece();
+}
+
+void hold(void) {
+	const CitrusPiece* next = game.hold_piece != NULL ? game.hold_piece : CitrusGame_get_next_piece(&game, 0);
+	press(CITRUS_KEY_HOLD);
+	held_piece = piece_id(next);
+	held_at = pieces;
+}
+
+// Plays the finesse keys that have been pressed, one piece at a time.
+// Slides hold their key over ticks, so this carries on from tick() until
+// the move is done.
+void play_finesse(void) {
+	while (CitrusGame_is_alive(&game) && hold_left == 0) {
+		if (finesse_move != NULL) {
+			if (finesse_step == finesse_move->n_steps) {
+				press(CITRUS_KEY_HARD_DROP);
+				finesse_move = NULL;
+				continue;
+			}
+			const FinesseStep* step = &finesse_move->steps[finesse_step++];
+			if (step->hold_ticks > 0) {
+				game_key_down(step->key);
+				hold_left = step->hold_ticks;
+			} else {
+				for (int i = 0; i < step->count; i++)
+					press(step->key);
+			}
+			continue;
+		}
+		if (n_finesse_keys == 0)
+			return;
+		int c = finesse_keys[first_finesse_key];
+		// a piece that came out of hold can't be held again, so then the
+		// key is dropped without waiting for a piece
+		int piece = -1;
+		if (c != ' ' || pieces != held_at) {
+			piece = current_piece();
+			if (piece == -1)
+				return;
+		}
+		first_finesse_key = (first_finesse_key + 1) % MAX_FINESSE_KEYS;
+		n_finesse_keys--;
+		if (c == ' ') {
+			if (piece != -1)
+				hold();
+		} else {
+			int index = keymap[c];
+			const FinesseMove* move = &finesse_table[piece][index / KEY_COLUMNS][index % KEY_COLUMNS];
+			if (move->found) {
+				finesse_move = move;
+				finesse_step = 0;
+			}
+		}
 	}
-	board = malloc(sizeof(CitrusCell) * config.full_height * config.width);
-	next_piece_queue = malloc(sizeof(CitrusPiece*) * config.next_piece_queue_size);
-	CitrusGame_init(&game, board, next_piece_queue, config, randomizer, NULL);
 }
 
 int string_to_int(const char* s, int minimum) {
@@ -165,29 +273,262 @@ int string_to_int(const char* s, int minimum) {
 	return i;
 }
 
-void resize(void) {
-	int width, height;
-	backend.get_size(&width, &height);
-	board_win.width = config.width * 2 + 2;
-	board_win.height = config.full_height + 2;
-	board_win.x = (width - board_win.width) / 2;
-	board_win.y = 4;
-	hold_win.width = 10;
-	hold_win.height = 6;
-	hold_win.x = board_win.x - hold_win.width - 2;
-	hold_win.y = board_win.y;
-	next_piece_win.width = 10;
-	next_piece_win.height = config.next_piece_queue_size * 4 + 2;
-	next_piece_win.x = board_win.x + board_win.width;
-	next_piece_win.y = board_win.y;
+bool game_running(void);
+void tick(void);
+
+void handle_key(KeyType type, int c) {
+	if (type != KEYTYPE_NONE && c == K_RESIZE) {
+		render_lock();
+		resize();
+		backend.clear_screen();
+		backend.resize_window(&hold_win);
+		backend.resize_window(&board_win);
+		backend.resize_window(&next_piece_win);
+		if (show_minimap)
+			backend.resize_window(&minimap_win);
+		if (versus)
+			backend.resize_window(&opponent_win);
+		invalidate_frame();
+		render_unlock();
+	}
+	if (replaying) {
+		// while watching a replay, the arrow keys seek by a second
+		if (type == KEYTYPE_PRESS || type == KEYTYPE_DOWN) {
+			if (c == K_LEFT) {
+				render_lock();
+				rewind_back(tick_rate);
+				render_unlock();
+			} else if (c == K_RIGHT) {
+				for (int i = 0; i < tick_rate && game_running(); i++)
+					tick();
+			}
+		}
+	} else if (one_key_finesse) {
+		if (type == KEYTYPE_PRESS || type == KEYTYPE_DOWN) {
+			bool known = c == ' ' || (c >= 0 && c < 256 && keymap[c] != -1);
+			if (known && n_finesse_keys < MAX_FINESSE_KEYS) {
+				finesse_keys[(first_finesse_key + n_finesse_keys) % MAX_FINESSE_KEYS] = c;
+				n_finesse_keys++;
+				play_finesse();
+			}
+		}
+	} else if (practice && c == 'b') {
+		if (type == KEYTYPE_PRESS || type == KEYTYPE_DOWN) {
+			render_lock();
+			rewind_back(tick_rate);
+			render_unlock();
+			// the keys held back then might not be held now
+			for (int key = 0; key < 8; key++)
+				CitrusGame_key_up(&game, key);
+		}
+	} else {
+		if (type != KEYTYPE_NONE) {
+			int key = -1;
+			switch (c) {
+				case K_LEFT: key = CITRUS_KEY_LEFT; break;
+				case K_RIGHT: key = CITRUS_KEY_RIGHT; break;
+				case K_DOWN: key = CITRUS_KEY_SOFT_DROP; break;
+				case ' ': key = CITRUS_KEY_HARD_DROP; break;
+				case 'z': key = CITRUS_KEY_ANTICLOCKWISE; break;
+				case 'x': case K_UP: key = CITRUS_KEY_CLOCKWISE; break;
+				case 'c': key = CITRUS_KEY_HOLD; break;
+				case 'a': key = CITRUS_KEY_180; break;
+			}
+			if (type == KEYTYPE_DOWN) {
+				game_key_down(key);
+			} else if (type == KEYTYPE_UP) {
+				game_key_up(key);
+			} else if (type == KEYTYPE_PRESS) {
+				game_key_down(key);
+				game_key_up(key);
+			}
+		}
+	}
+}
+
+bool game_running(void) {
+	if (client_connected())
+		return client_alive();
+	if (replaying && replay_finished())
+		return false;
+	if (versus && !versus_bot_alive())
+		return false;
+	return CitrusGame_is_alive(&game);
+}
+
+void tick(void) {
+	if (client_connected()) {
+		// the game runs on the server
+		client_poll();
+		return;
+	}
+	if (!CitrusGame_is_alive(&game))
+		return;
+	if (replaying) {
+		replay_apply();
+		if (!CitrusGame_is_alive(&game))
+			return;
+	}
+	CitrusGame_tick(&game);
+	ticks++;
+	if (versus)
+		versus_tick();
+	if (rewinding)
+		rewind_push();
+	if (one_key_finesse && !replaying) {
+		if (hold_left > 0 && --hold_left == 0)
+			game_key_up(finesse_move->steps[finesse_step - 1].key);
+		play_finesse();
+	}
+}
+
+void timed_tick(void) {
+	double start = now();
+	tick();
+	profile_record(PHASE_TICK, start, now());
+}
+
+// Runs the game until the player dies. The simulation runs at a fixed
+// tick_rate, while the screen is redrawn at most render_rate times per
+// second and only when something happened since the last frame. When
+// nothing on screen will change for a while, the loop sleeps through those
+// ticks and runs them all when it wakes up, at least once a second. If
+// there is a render thread, frames are handed to it instead of drawn here.
+void run(void) {
+	double tick_length = 1.0 / tick_rate;
+	double frame_length = render_rate > 0 ? 1.0 / render_rate : 0;
+	double next_tick = now() + tick_length;
+	double next_frame = now();
+	bool dirty = false;
+	bool can_idle = can_lookahead && !show_stats && !versus;
+	while (game_running()) {
+		double deadline = next_tick;
+		if (dirty && next_frame < deadline)
+			deadline = next_frame;
+		// ticks that can be run late, since nobody would see them
+		int idle_ticks = 0;
+		// finesse moves press keys from tick(), which the lookahead
+		// doesn't know about
+		if (!dirty && can_idle && finesse_move == NULL && n_finesse_keys == 0) {
+			idle_ticks = ticks_until_change(tick_rate) - 1;
+			deadline += idle_ticks * tick_length;
+		}
+		int max_ticks = MAX_CATCH_UP_TICKS + idle_ticks;
+		double timeout = deadline - now();
+		if (timeout < 0)
+			timeout = 0;
+		InputEvent event;
+		double wait_start = now();
+		bool have_event = input_get(timeout, &event);
+		double time = now();
+		profile_record(PHASE_WAIT, wait_start, time);
+		int n_ticks = 0;
+		while (have_event) {
+			// run the ticks that happened before the key was pressed,
+			// so that it is applied on the tick it was pressed in
+			while (event.time >= next_tick && n_ticks < max_ticks) {
+				timed_tick();
+				n_ticks++;
+				next_tick += tick_length;
+			}
+			double start = now();
+			handle_key(event.type, event.key);
+			profile_record(PHASE_INPUT, start, now());
+			dirty = true;
+			have_event = input_get(0, &event);
+		}
+		while (time >= next_tick && n_ticks < max_ticks) {
+			timed_tick();
+			n_ticks++;
+			next_tick += tick_length;
+			dirty = true;
+		}
+		if (time >= next_tick) {
+			// too far behind to catch up without a burst of ticks, so
+			// slow the game down instead
+			next_tick = time + tick_length;
+		}
+		if (dirty && time >= next_frame) {
+			if (render_threaded) {
+				View view;
+				get_view(&view);
+				render_publish(&view);
+			} else {
+				double start = now();
+				update();
+				profile_record(PHASE_UPDATE, start, now());
+			}
+			if (broadcast_address != NULL)
+				broadcast();
+			dirty = false;
+			next_frame += frame_length;
+			if (next_frame < time)
+				next_frame = time;
+		}
+	}
+}
+
+void fill_record(LeaderboardRecord* record) {
+	memset(record, 0, sizeof(*record));
+	strncpy(record->player, player_name, LEADERBOARD_NAME_SIZE - 1);
+	record->config_hash = leaderboard_config_hash();
+	record->score = game.score;
+	record->lines = game.lines;
+	record->pieces = pieces;
+	record->ticks = ticks;
+	record->pps = ticks > 0 ? (float) pieces / ((float) ticks / tick_rate) : 0;
+	record->time = time(NULL);
+}
+
+// Adds the game that just ended to the leaderboard, and shows the best
+// scores with its config over the board.
+void show_leaderboard(const char* result) {
+	LeaderboardRecord record;
+	fill_record(&record);
+	char replay_full_path[PATH_MAX];
+	const char* replay = NULL;
+	if (record_path != NULL)
+		replay = realpath(record_path, replay_full_path) != NULL ? replay_full_path : record_path;
+	int rank;
+	if (!leaderboard_add(&record, replay, &rank)) {
+		print_action_text("%s", result);
+		return;
+	}
+	print_action_text("%s: #%i", result, rank);
+	LeaderboardRecord top[LEADERBOARD_ROWS];
+	int n = leaderboard_top(record.config_hash, LEADERBOARD_ROWS, top);
+	blank_board();
+	print_board_line(0, "Best scores");
+	for (int i = 0; i < n; i++)
+		print_board_line(i + 2, "%2i %-8.8s %8i", i + 1, top[i].player, top[i].score);
+	backend.full_update();
+}
+
+// prints the best games with the chosen config, and the player's own
+void print_scores(void) {
+	uint32_t hash = leaderboard_config_hash();
+	LeaderboardRecord records[LEADERBOARD_ROWS];
+	int n = leaderboard_top(hash, LEADERBOARD_ROWS, records);
+	printf("best of %li games:\n", leaderboard_count());
+	for (int i = 0; i < n; i++)
+		printf("%2i %-*s %8i %5i lines %5.2f PPS\n", i + 1, LEADERBOARD_NAME_SIZE, records[i].player, records[i].score, records[i].lines, records[i].pps);
+	n = leaderboard_player(player_name, hash, LEADERBOARD_ROWS, records);
+	printf("best of %s:\n", player_name);
+	for (int i = 0; i < n; i++) {
+		char replay[PATH_MAX];
+		printf("%2i %8i %5i lines %5.2f PPS %s\n", i + 1, records[i].score, records[i].lines, records[i].pps,
+			leaderboard_replay_path(&records[i], replay, sizeof(replay)) ? replay : "");
+	}
 }
 
 int main(int argc, char** argv) {
+	double start_time = now();
 	program_name = argv[0];
+	game_hooks = (GameHooks) {send_key, get_view, draw_stats, record_flush};
 	config = citrus_preset_modern;
 	int c;
 	backend = DEFAULT_BACKEND;
-	while ((c = getopt(argc, argv, "1cDSa:d:f:F:g:h:l:L:m:q:s:w:")) != -1) {
+	while ((c = getopt_long(argc, argv, "1AcDHkMPpSVvya:b:B:C:d:f:F:g:h:l:L:m:N:o:q:r:R:s:t:T:u:U:w:n:W:X:Y:", long_options, NULL)) != -1) {
 		switch (c) {
 			case 'w':
 				config.width = string_to_int(optarg, 4);
@@ -218,9 +559,11 @@ int main(int argc, char** argv) {
 				break;
 			case 'c':
 				config = citrus_preset_classic;
+				preset = 1;
 				break;
 			case 'D':
 				config = citrus_preset_delayless;
+				preset = 2;
 				break;
 			case '1':
 				one_key_finesse = true;
@@ -231,6 +574,86 @@ int main(int argc, char** argv) {
 			case 'd':
 				config.das = string_to_int(optarg, 0);
 				break;
+			case 't':
+				tick_rate = string_to_int(optarg, 1);
+				break;
+			case 'r':
+				render_rate = string_to_int(optarg, 0);
+				break;
+			case 'o':
+				record_path = optarg;
+				break;
+			case 'R':
+				replay_path = optarg;
+				break;
+			case 'H':
+				headless = true;
+				break;
+			case 'v':
+				verify = true;
+				break;
+			case 'X':
+				server_address = optarg;
+				break;
+			case 'Y':
+				host_address = optarg;
+				break;
+			case 'C':
+				connect_address = optarg;
+				break;
+			case 'N':
+				room = string_to_int(optarg, 0);
+				break;
+			case 'W':
+				watch_address = optarg;
+				break;
+			case 'B':
+				broadcast_address = optarg;
+				break;
+			case 'P':
+				show_stats = true;
+				break;
+			case 'M':
+				show_minimap = true;
+				break;
+			case 'T':
+				trace_path = optarg;
+				break;
+			case 'p':
+				practice = true;
+				break;
+			case 'b':
+				leaderboard_path = optarg;
+				break;
+			case 'n':
+				player_name = optarg;
+				break;
+			case 'k':
+				list_scores = true;
+				break;
+			case 'y':
+				versus = true;
+				break;
+			case 'u':
+				bot_pps = strtod(optarg, NULL);
+				if (bot_pps <= 0) {
+					fprintf(stderr, "%s: the bot's PPS must be positive\n", program_name);
+					exit(-1);
+				}
+				break;
+			case 'U':
+				// in milliseconds
+				bot_budget = string_to_int(optarg, 1) / 1000.0;
+				break;
+#ifdef ANSI_BACKEND
+			case 'A':
+				backend = ansi_backend;
+				break;
+#else
+			case 'A':
+				fprintf(stderr, "%s: ansi backend not included\n", program_name);
+				exit(-1);
+#endif
 #ifdef SDL3_BACKEND
 			case 'S':
 				backend = sdl3_backend;
@@ -238,9 +661,14 @@ int main(int argc, char** argv) {
 			case 'F':
 				font_path = optarg;
 				break;
+			case 'V':
+				vsync = true;
+				render_rate = 0;
+				break;
 #else
 			case 'S':
 			case 'F':
+			case 'V':
 				fprintf(stderr, "%s: sdl3 not included\n", program_name);
 				exit(-1);
 #endif
@@ -258,111 +686,186 @@ int main(int argc, char** argv) {
 			extra_height = 20;
 		config.full_height = config.height + extra_height;
 	}
-	init_citrus();
-	backend.init();
-	resize();
-	backend.set_target_size(config.width * 2 + 28, config.full_height + 8);
-	backend.init_window(&hold_win);
-	backend.init_window(&board_win);
-	backend.init_window(&next_piece_win);
-	update();
-	double time_since_tick = 0;
-	struct timespec curr_time, prev_time;
-	clock_gettime(CLOCK_MONOTONIC, &curr_time);
-	while (CitrusGame_is_alive(&game)) {
-		int ms_timeout = (1.0 / 60.0 - time_since_tick) * 1e3;
-		if (ms_timeout < 0)
-			ms_timeout = 0;
-		int c;
-		KeyType type = backend.get_key(ms_timeout, &c);
-		if (type != KEYTYPE_NONE && c == K_RESIZE) {
-			resize();
-			backend.clear_screen();
-			backend.resize_window(&hold_win);
-			backend.resize_window(&board_win);
-			backend.resize_window(&next_piece_win);
+	if (!valid_board_size(config.width, config.full_height, config.next_piece_queue_size)) {
+		fprintf(stderr, "%s: board must have at most %i cells and queue at most %i pieces\n", program_name, MAX_BOARD_CELLS, MAX_QUEUE_SIZE);
+		exit(-1);
+	}
+	if (server_address != NULL) {
+#ifdef SERVER
+		return run_server(server_address);
+#else
+		fprintf(stderr, "%s: server not included\n", program_name);
+		exit(-1);
+#endif
+	}
+	if (player_name == NULL)
+		player_name = getenv("USER") != NULL ? getenv("USER") : "player";
+	if (leaderboard_path != NULL && !leaderboard_open(leaderboard_path)) {
+		fprintf(stderr, "%s: can't open leaderboard %s\n", program_name, leaderboard_path);
+		exit(-1);
+	}
+	if (list_scores) {
+		if (leaderboard_path == NULL) {
+			fprintf(stderr, "%s: --scores needs --leaderboard\n", program_name);
+			exit(-1);
 		}
-		if (one_key_finesse) {
-			if (type == KEYTYPE_PRESS || type == KEYTYPE_DOWN) {
-				int rotation, column;
-				for (rotation = 0; rotation < 4; rotation++) {
-					for (column = 0; column < 10; column++) {
-						if (rows[rotation][column] == c) {
-							goto found;
-						}
-					}
-				}
-				found:
-				if (rotation != 4) {
-					for (int i = 0; i < rotation; i++) {
-						CitrusGame_key_down(&game, CITRUS_KEY_CLOCKWISE);
-						CitrusGame_key_up(&game, CITRUS_KEY_CLOCKWISE);
-					}
-					if (column < 5) {
-						for (int i = 0; i < 10; i++) {
-							CitrusGame_key_down(&game, CITRUS_KEY_LEFT);
-							CitrusGame_key_up(&game, CITRUS_KEY_LEFT);
-						}
-						for (int i = 0; i < column; i++) {
-							CitrusGame_key_down(&game, CITRUS_KEY_RIGHT);
-							CitrusGame_key_up(&game, CITRUS_KEY_RIGHT);
-						}
-					} else {
-						for (int i = 0; i < 10; i++) {
-							CitrusGame_key_down(&game, CITRUS_KEY_RIGHT);
-							CitrusGame_key_up(&game, CITRUS_KEY_RIGHT);
-						}
-						for (int i = 0; i < 9 - column; i++) {
-							CitrusGame_key_down(&game, CITRUS_KEY_LEFT);
-							CitrusGame_key_up(&game, CITRUS_KEY_LEFT);
-						}
-					}
-					CitrusGame_key_down(&game, CITRUS_KEY_HARD_DROP);
-					CitrusGame_key_up(&game, CITRUS_KEY_HARD_DROP);
-				} else if (c == ' ') {
-					CitrusGame_key_down(&game, CITRUS_KEY_HOLD);
-					CitrusGame_key_up(&game, CITRUS_KEY_HOLD);
-				}
-			}
-		} else {
-			if (type != KEYTYPE_NONE) {
-				int key = -1;
-				switch (c) {
-					case K_LEFT: key = CITRUS_KEY_LEFT; break;
-					case K_RIGHT: key = CITRUS_KEY_RIGHT; break;
-					case K_DOWN: key = CITRUS_KEY_SOFT_DROP; break;
-					case ' ': key = CITRUS_KEY_HARD_DROP; break;
-					case 'z': key = CITRUS_KEY_ANTICLOCKWISE; break;
-					case 'x': case K_UP: key = CITRUS_KEY_CLOCKWISE; break;
-					case 'c': key = CITRUS_KEY_HOLD; break;
-					case 'a': key = CITRUS_KEY_180; break;
-				}
-				if (type == KEYTYPE_DOWN) {
-					CitrusGame_key_down(&game, key);
-				} else if (type == KEYTYPE_UP) {
-					CitrusGame_key_up(&game, key);
-				} else if (type == KEYTYPE_PRESS) {
-					CitrusGame_key_down(&game, key);
-					CitrusGame_key_up(&game, key);
-				}
-			}
+		print_scores();
+		leaderboard_close();
+		return 0;
+	}
+	if (host_address != NULL) {
+#ifdef SERVER
+		return run_host(host_address, leaderboard_path != NULL);
+#else
+		fprintf(stderr, "%s: hosting not included\n", program_name);
+		exit(-1);
+#endif
+	}
+#ifndef SERVER
+	if (broadcast_address != NULL) {
+		fprintf(stderr, "%s: broadcasting not included\n", program_name);
+		exit(-1);
+	}
+#endif
+	unsigned int seed = time(NULL);
+	if (replay_path != NULL && !replay_open(replay_path, &seed)) {
+		fprintf(stderr, "%s: can't read replay %s\n", program_name, replay_path);
+		exit(-1);
+	}
+	if (headless && replay_path == NULL) {
+		fprintf(stderr, "%s: --headless needs a replay\n", program_name);
+		exit(-1);
+	}
+	if ((connect_address != NULL || watch_address != NULL) && (replay_path != NULL || record_path != NULL)) {
+		fprintf(stderr, "%s: replays can't be used with --connect or --watch\n", program_name);
+		exit(-1);
+	}
+	if (practice && (replay_path != NULL || record_path != NULL || connect_address != NULL || watch_address != NULL)) {
+		fprintf(stderr, "%s: --practice can't be used with replays, --connect or --watch\n", program_name);
+		exit(-1);
+	}
+	if (leaderboard_path != NULL && (replay_path != NULL || practice || connect_address != NULL || watch_address != NULL)) {
+		fprintf(stderr, "%s: --leaderboard can't be used with --replay, --practice, --connect or --watch\n", program_name);
+		exit(-1);
+	}
+	if (versus && (replay_path != NULL || practice || connect_address != NULL || watch_address != NULL)) {
+		fprintf(stderr, "%s: --versus can't be used with --replay, --practice, --connect or --watch\n", program_name);
+		exit(-1);
+	}
+	if (versus && (config.width > BITBOARD_MAX_WIDTH || config.full_height > BITBOARD_MAX_HEIGHT)) {
+		fprintf(stderr, "%s: --versus board must be at most %ix%i\n", program_name, BITBOARD_MAX_WIDTH, BITBOARD_MAX_HEIGHT);
+		exit(-1);
+	}
+	if (one_key_finesse && (practice || connect_address != NULL || watch_address != NULL)) {
+		fprintf(stderr, "%s: -1 can't be used with --practice, --connect or --watch\n", program_name);
+		exit(-1);
+	}
+	if (connect_address != NULL) {
+		if (!client_connect(connect_address, room)) {
+			fprintf(stderr, "%s: can't join %s\n", program_name, connect_address);
+			exit(-1);
+		}
+	} else if (watch_address != NULL) {
+		if (!client_watch(watch_address)) {
+			fprintf(stderr, "%s: can't watch %s\n", program_name, watch_address);
+			exit(-1);
+		}
+	} else {
+		init_citrus(seed);
+		if (versus)
+			versus_start(seed);
+	}
+	if (!headless && !replaying && connect_address == NULL && watch_address == NULL) {
+		// for working out how long the main loop can sleep, and which
+		// piece is falling in one key finesse mode
+		can_lookahead = lookahead_start();
+	}
+	if (one_key_finesse && !replaying) {
+		init_keymap();
+		if (!can_lookahead || !init_finesse()) {
+			fprintf(stderr, "%s: can't work out the finesse moves\n", program_name);
+			exit(-1);
 		}
-		prev_time = curr_time;
-		clock_gettime(CLOCK_MONOTONIC, &curr_time);
-		time_since_tick += curr_time.tv_sec - prev_time.tv_sec;
-		time_since_tick += (curr_time.tv_nsec - prev_time.tv_nsec) / 1e9;
-		while (time_since_tick >= 1.0 / 60.0) {
-			time_since_tick -= 1.0 / 60.0;
-			CitrusGame_tick(&game);
-			ticks++;
+		free_finesse();
+	}
+	rewinding = practice || (replaying && !headless);
+	if (rewinding) {
+		if (!rewind_start(REWIND_SECONDS * tick_rate, REWIND_MEMORY, KEYFRAME_INTERVAL)) {
+			fprintf(stderr, "%s: out of memory\n", program_name);
+			exit(-1);
 		}
+		rewind_push();
+	}
+	if (record_path != NULL && !replay_record_start(record_path, preset, seed)) {
+		fprintf(stderr, "%s: can't write replay %s\n", program_name, record_path);
+		exit(-1);
+	}
+	if ((show_stats || trace_path != NULL) && !profile_start(trace_path)) {
+		perror(trace_path);
+		exit(-1);
+	}
+#ifdef SERVER
+	if (broadcast_address != NULL && !broadcast_start(broadcast_address)) {
+		perror(broadcast_address);
+		exit(-1);
+	}
+#endif
+	if (headless) {
+		// play the replay back as fast as possible
+		backend = headless_backend;
+		backend.init();
+		init_windows();
+		double start = now();
+		while (CitrusGame_is_alive(&game) && !replay_finished())
+			tick();
+		double elapsed = now() - start;
+		printf("ticks %i score %i lines %i pieces %i (%.0f ticks/s)\n", ticks, game.score, game.lines, pieces, ticks / elapsed);
+	} else {
+		backend.init();
+		double init_end = now();
+		init_windows();
 		update();
+		profile_startup(start_time, init_end, now());
+		input_start();
+		render_start();
+		run();
+		render_stop();
+		input_stop();
+		if (broadcast_address != NULL)
+			broadcast();
+#ifdef SERVER
+		broadcast_stop();
+#endif
+		const char* result = game_running() ? "Replay ended" : "You died";
+		if (versus)
+			result = CitrusGame_is_alive(&game) ? "You win" : "The bot wins";
+		if (leaderboard_path != NULL && !game_running())
+			show_leaderboard(result);
+		else
+			print_action_text("%s", result);
+		sleep(5);
 	}
-	print_action_text("You died");
-	sleep(5);
 	backend.exit();
-	free(board);
-	free(next_piece_queue);
-	free(randomizer);
-	return 0;
+	profile_report();
+	profile_stop();
+	replay_record_end();
+	int status = 0;
+	if (replaying && verify) {
+		if (replay_verify()) {
+			printf("replay verified\n");
+		} else {
+			printf("replay does not match\n");
+			status = 1;
+		}
+	}
+	replay_close();
+	leaderboard_close();
+	versus_stop();
+	if (versus)
+		versus_report();
+	client_disconnect();
+	rewind_stop();
+	lookahead_stop();
+	free_citrus();
+	return status;
 }
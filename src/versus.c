@@ -0,0 +1,276 @@
+/* Copyright (C) 2026 RZ781
+ *
+ * This file is part of txtris.
+ *
+ * txtris is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * txtris is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bitboard.h"
+#include "bot.h"
+#include "versus.h"
+
+// A local game against a bot, which plays its own game with the same
+// pieces next to the player's. The bot's moves are searched for on a worker
+// thread, so the main loop only ticks the bot's game and polls for the
+// answer. Every search stops at a deadline of bot_budget seconds, and the
+// bot places at most bot_pps pieces per second, which together set how
+// strong it is. Like in the multiplayer server, lines sent are counted and
+// shown, and whoever tops out first loses.
+
+#define MAX_BEAM_WIDTH 256
+
+bool versus = false;
+double bot_pps = 1.0;
+double bot_budget = 0.05;
+
+CitrusGame bot_game;
+CitrusCell* bot_board;
+const CitrusPiece** bot_queue;
+union {
+	CitrusBagRandomizer bag;
+	CitrusClassicRandomizer classic;
+} bot_randomizer;
+View bot_view;
+// the bot's own action text, drawn over its board
+char bot_action_text[ACTION_TEXT_SIZE];
+int bot_pieces = 0;
+int bot_ticks = 0;
+int bot_attack = 0;
+int bot_last_clear = 0;
+// which piece is falling, found the same way as in txtris-sim
+int bot_current = -1;
+int bot_tracked_pieces = 0;
+const CitrusPiece* bot_tracked_next = NULL;
+// when the falling piece can be searched for, or -1 once it has been, and
+// the earliest that it can be placed
+int bot_search_tick = 0;
+int bot_act_tick = 0;
+int bot_placed_tick = 0;
+bool bot_searching = false;
+
+// the search the worker is asked to do, and its answer
+typedef struct {
+	Bitboard board;
+	int pieces[MAX_SEARCH_PIECES];
+	int n_pieces;
+	double deadline;
+	int id;
+} BotJob;
+
+pthread_t bot_thread;
+pthread_mutex_t bot_job_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t bot_job_cond = PTHREAD_COND_INITIALIZER;
+BotJob bot_job;
+bool bot_job_pending = false;
+bool bot_thread_running = false;
+int bot_job_id = 0;
+Placement bot_answer;
+bool bot_answer_found;
+atomic_int bot_answer_id = 0;
+// totals over the game, for the report at the end
+long bot_nodes = 0;
+long bot_searches = 0;
+long bot_full_searches = 0;
+int bot_widest = 0;
+
+void* bot_thread_main(void* data) {
+	(void) data;
+	BotSearch search;
+	bot_search_init(&search, MAX_BEAM_WIDTH);
+	pthread_mutex_lock(&bot_job_lock);
+	while (true) {
+		while (bot_thread_running && !bot_job_pending)
+			pthread_cond_wait(&bot_job_cond, &bot_job_lock);
+		if (!bot_thread_running)
+			break;
+		BotJob job = bot_job;
+		bot_job_pending = false;
+		pthread_mutex_unlock(&bot_job_lock);
+		BotSearchStats stats;
+		bot_answer_found = bot_search(&search, &job.board, job.pieces, job.n_pieces, config.height, job.deadline, &bot_answer, &stats);
+		bot_nodes += stats.nodes;
+		bot_searches++;
+		bot_full_searches += stats.width > 0;
+		if (stats.width > bot_widest)
+			bot_widest = stats.width;
+		atomic_store_explicit(&bot_answer_id, job.id, memory_order_release);
+		pthread_mutex_lock(&bot_job_lock);
+	}
+	pthread_mutex_unlock(&bot_job_lock);
+	bot_search_free(&search);
+	return NULL;
+}
+
+void bot_action_text_callback(void* data, int n_lines_cleared, int combo, bool b2b, bool all_clear, bool spin, bool mini_spin) {
+	(void) data;
+	(void) mini_spin;
+	bot_pieces++;
+	bot_last_clear = n_lines_cleared;
+	int attack = clear_attack(n_lines_cleared, combo, b2b, all_clear, spin);
+	if (attack > 0) {
+		bot_attack += attack;
+		snprintf(bot_action_text, sizeof(bot_action_text), "Sent %i lines", attack);
+		bot_view.action_text_count++;
+	}
+}
+
+// Plays against a bot that gets the same pieces as the player.
+void versus_start(unsigned int seed) {
+	init_piece_table();
+	init_piece_shapes();
+	CitrusGameConfig bot_config = config;
+	bot_config.action_text = bot_action_text_callback;
+	if (config.randomizer == CitrusBagRandomizer_randomizer)
+		CitrusBagRandomizer_init(&bot_randomizer.bag, seed);
+	else
+		CitrusClassicRandomizer_init(&bot_randomizer.classic, seed);
+	bot_board = malloc(sizeof(CitrusCell) * config.width * config.full_height);
+	bot_queue = malloc(sizeof(CitrusPiece*) * config.next_piece_queue_size);
+	CitrusGame_init(&bot_game, bot_board, bot_queue, bot_config, &bot_randomizer, NULL);
+	// at the start, the only full cells belong to the falling piece
+	for (int i = 0; i < config.width * config.full_height; i++) {
+		if (bot_board[i].type == CITRUS_CELL_FULL)
+			bot_current = bot_board[i].color;
+	}
+	bot_tracked_next = CitrusGame_get_next_piece(&bot_game, 0);
+	bot_act_tick = tick_rate / bot_pps;
+	bot_view.board = bot_board;
+	bot_view.next_pieces = NULL;
+	bot_view.action_text = bot_action_text;
+	opponent_view = &bot_view;
+	bot_thread_running = true;
+	pthread_create(&bot_thread, NULL, bot_thread_main, NULL);
+}
+
+void bot_press(CitrusKey key) {
+	CitrusGame_key_down(&bot_game, key);
+	CitrusGame_key_up(&bot_game, key);
+}
+
+// Asks the worker where to put the falling piece. libcitrus doesn't say
+// where the falling piece is, but it has only just spawned, so its cells are
+// the highest ones of its color.
+void start_bot_search(void) {
+	Bitboard bitboard;
+	// main() turns down boards too big for a bitboard, so this shouldn't
+	// fail, but the bot just doesn't move if it does
+	if (!bitboard_from_cells(&bitboard, bot_board, config.width, config.full_height))
+		return;
+	int removed = 0;
+	for (int y = config.full_height - 1; y >= 0 && removed < 4; y--) {
+		for (int x = 0; x < config.width && removed < 4; x++) {
+			CitrusCell cell = bot_board[y * config.width + x];
+			if (cell.type == CITRUS_CELL_FULL && (int) cell.color == bot_current) {
+				bitboard.rows[y] &= ~((uint64_t) 1 << x);
+				removed++;
+			}
+		}
+	}
+	pthread_mutex_lock(&bot_job_lock);
+	bot_job.board = bitboard;
+	bot_job.pieces[0] = bot_current;
+	bot_job.n_pieces = 1;
+	for (int i = 0; i < config.next_piece_queue_size && bot_job.n_pieces < MAX_SEARCH_PIECES; i++)
+		bot_job.pieces[bot_job.n_pieces++] = piece_id(CitrusGame_get_next_piece(&bot_game, i));
+	bot_job.deadline = now() + bot_budget;
+	bot_job.id = ++bot_job_id;
+	bot_job_pending = true;
+	pthread_cond_signal(&bot_job_cond);
+	pthread_mutex_unlock(&bot_job_lock);
+	bot_searching = true;
+}
+
+void play_bot_answer(void) {
+	if (bot_answer_found) {
+		if (bot_answer.rotation == 1)
+			bot_press(CITRUS_KEY_CLOCKWISE);
+		else if (bot_answer.rotation == 2)
+			bot_press(CITRUS_KEY_180);
+		else if (bot_answer.rotation == 3)
+			bot_press(CITRUS_KEY_ANTICLOCKWISE);
+		int shift = placement_shift(&bot_answer, config.width);
+		for (int i = 0; i < abs(shift); i++)
+			bot_press(shift < 0 ? CITRUS_KEY_LEFT : CITRUS_KEY_RIGHT);
+	}
+	bot_press(CITRUS_KEY_HARD_DROP);
+}
+
+// Runs a tick of the bot's game. The search for a piece starts as soon as
+// it spawns, and the piece is placed once the search is done and enough
+// time has passed since the last one to keep to bot_pps.
+void versus_tick(void) {
+	if (!CitrusGame_is_alive(&bot_game))
+		return;
+	CitrusGame_tick(&bot_game);
+	bot_ticks++;
+	if (bot_pieces != bot_tracked_pieces) {
+		// the piece at the front of the queue has started falling,
+		// after the cleared lines have gone
+		bot_current = piece_id(bot_tracked_next);
+		bot_tracked_pieces = bot_pieces;
+		bot_search_tick = bot_ticks + (bot_last_clear > 0 ? config.line_clear_delay : 0);
+		bot_act_tick = bot_placed_tick + tick_rate / bot_pps;
+		if (bot_act_tick < bot_search_tick)
+			bot_act_tick = bot_search_tick;
+	}
+	bot_tracked_next = CitrusGame_get_next_piece(&bot_game, 0);
+	if (bot_search_tick >= 0 && bot_ticks >= bot_search_tick) {
+		start_bot_search();
+		bot_search_tick = -1;
+	}
+	if (bot_searching && bot_ticks >= bot_act_tick
+		&& atomic_load_explicit(&bot_answer_id, memory_order_acquire) == bot_job_id) {
+		play_bot_answer();
+		bot_searching = false;
+		bot_placed_tick = bot_ticks;
+	}
+	bot_view.hold_piece = bot_game.hold_piece;
+	bot_view.score = bot_game.score;
+	bot_view.level = bot_game.level;
+	bot_view.lines = bot_game.lines;
+	bot_view.pieces = bot_pieces;
+	bot_view.ticks = bot_ticks;
+	bot_view.attack = bot_attack;
+}
+
+bool versus_bot_alive(void) {
+	return CitrusGame_is_alive(&bot_game);
+}
+
+void versus_report(void) {
+	if (bot_searches == 0)
+		return;
+	printf("bot: %li pieces, %.0f nodes per piece, %.0f%% looked %i pieces ahead, widest beam %i\n",
+		bot_searches, (double) bot_nodes / bot_searches, 100.0 * bot_full_searches / bot_searches,
+		1 + (config.next_piece_queue_size < MAX_SEARCH_PIECES - 1 ? config.next_piece_queue_size : MAX_SEARCH_PIECES - 1), bot_widest);
+}
+
+void versus_stop(void) {
+	if (!bot_thread_running)
+		return;
+	pthread_mutex_lock(&bot_job_lock);
+	bot_thread_running = false;
+	pthread_cond_signal(&bot_job_cond);
+	pthread_mutex_unlock(&bot_job_lock);
+	pthread_join(bot_thread, NULL);
+	opponent_view = NULL;
+	free(bot_board);
+	free(bot_queue);
+}